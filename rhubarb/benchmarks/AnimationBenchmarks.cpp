@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include "animation/mouthAnimation.h"
+
+// Returns a random phone sequence with occasional pauses, at a typical speaking rate
+BoundedTimeline<Phone> createPhoneTimeline(int seconds) {
+	const centiseconds duration(seconds * 100);
+	BoundedTimeline<Phone> phones(TimeRange(0_cs, duration));
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> phoneDistribution(
+		static_cast<int>(Phone::AO),
+		static_cast<int>(Phone::W)
+	);
+	std::uniform_int_distribution<int> phoneDurationDistribution(4, 15);
+	std::uniform_int_distribution<int> pauseDistribution(0, 19);
+	for (centiseconds start = 0_cs; start < duration;) {
+		const centiseconds end = start + centiseconds(phoneDurationDistribution(random));
+		phones.set(start, end, static_cast<Phone>(phoneDistribution(random)));
+		// Pause after about one phone in 20
+		start = end + (pauseDistribution(random) == 0 ? 50_cs : 0_cs);
+	}
+	return phones;
+}
+
+static void Animation_animate(benchmark::State& state, bool extendedShapes) {
+	const BoundedTimeline<Phone> phones = createPhoneTimeline(static_cast<int>(state.range(0)));
+	ShapeSet targetShapeSet = ShapeConverter::get().getBasicShapes();
+	if (extendedShapes) {
+		const ShapeSet extendedShapeSet = ShapeConverter::get().getExtendedShapes();
+		targetShapeSet.insert(extendedShapeSet.begin(), extendedShapeSet.end());
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(animate(phones, targetShapeSet));
+	}
+	state.SetItemsProcessed(state.iterations() * phones.size());
+}
+BENCHMARK_CAPTURE(Animation_animate, basicShapes, false)->Arg(10)->Arg(60)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Animation_animate, extendedShapes, true)->Arg(10)->Arg(60)->Unit(benchmark::kMillisecond);
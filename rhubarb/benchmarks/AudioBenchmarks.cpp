@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include "audio/WaveFileReader.h"
+#include "audio/MemoryAudioClip.h"
+#include "audio/SampleRateConverter.h"
+#include "audio/DcOffset.h"
+#include "audio/voiceActivityDetection.h"
+#include "tools/platformTools.h"
+
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+
+// Returns noise bursts, roughly resembling the rhythm of speech
+unique_ptr<AudioClip> createSyllableClip(int sampleRate, int durationSeconds = 10) {
+	const int sampleCount = sampleRate * durationSeconds;
+	auto samples = std::make_shared<vector<int16_t>>(sampleCount);
+	std::mt19937 random(0);
+	std::normal_distribution<float> noise(0.0f, 5000.0f);
+	for (int i = 0; i < sampleCount; ++i) {
+		// Four syllables per second, with a pause every two seconds
+		const double time = static_cast<double>(i) / sampleRate;
+		const double envelope = std::fmod(time, 2.0) < 1.5 ? std::abs(std::sin(4 * 3.14159 * time)) : 0.0;
+		(*samples)[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, envelope * noise(random))));
+	}
+	return make_unique<MemoryAudioClip>(samples, sampleRate);
+}
+
+// Reads all samples of the clip block by block, as the processing steps do
+void readAll(const AudioClip& clip) {
+	vector<float> block(4096);
+	for (AudioClip::size_type start = 0; start < clip.size(); start += block.size()) {
+		const auto blockSize = std::min<AudioClip::size_type>(block.size(), clip.size() - start);
+		clip.readBlock(start, gsl::span<float>(block.data(), blockSize));
+		benchmark::DoNotOptimize(block.data());
+	}
+}
+
+static void WaveFileReader_read(benchmark::State& state, const char* fileName) {
+	const auto filePath = getBinDirectory() / "tests/resources" / fileName;
+	unique_ptr<AudioClip> clip;
+	try {
+		clip = make_unique<WaveFileReader>(filePath);
+	} catch (const std::exception& e) {
+		state.SkipWithError(e.what());
+		return;
+	}
+	for (auto _ : state) {
+		readAll(*clip);
+	}
+	state.SetItemsProcessed(state.iterations() * clip->size());
+}
+BENCHMARK_CAPTURE(WaveFileReader_read, uint8, "sine-triangle-uint8-ffmpeg.wav");
+BENCHMARK_CAPTURE(WaveFileReader_read, int16, "sine-triangle-int16-ffmpeg.wav");
+BENCHMARK_CAPTURE(WaveFileReader_read, int24, "sine-triangle-int24-ffmpeg.wav");
+BENCHMARK_CAPTURE(WaveFileReader_read, int32, "sine-triangle-int32-ffmpeg.wav");
+BENCHMARK_CAPTURE(WaveFileReader_read, float32, "sine-triangle-float32-ffmpeg.wav");
+BENCHMARK_CAPTURE(WaveFileReader_read, float64, "sine-triangle-float64-ffmpeg.wav");
+
+static void SampleRateConverter_read(benchmark::State& state) {
+	const int inputSampleRate = static_cast<int>(state.range(0));
+	const unique_ptr<AudioClip> clip = createSyllableClip(inputSampleRate) | resample(16000);
+	for (auto _ : state) {
+		readAll(*clip);
+	}
+	state.SetItemsProcessed(state.iterations() * clip->size());
+}
+BENCHMARK(SampleRateConverter_read)->Arg(48000)->Arg(44100)->Arg(8000);
+
+static void DcOffset_remove(benchmark::State& state) {
+	const unique_ptr<AudioClip> inputClip = createSyllableClip(16000) | addDcOffset(0.1f);
+	for (auto _ : state) {
+		// Includes measuring the offset
+		const unique_ptr<AudioClip> clip = inputClip->clone() | removeDcOffset();
+		readAll(*clip);
+	}
+	state.SetItemsProcessed(state.iterations() * inputClip->size());
+}
+BENCHMARK(DcOffset_remove);
+
+static void VoiceActivityDetection_detect(benchmark::State& state) {
+	const int sampleRate = static_cast<int>(state.range(0));
+	const unique_ptr<AudioClip> clip = createSyllableClip(sampleRate);
+	NullProgressSink progressSink;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(detectVoiceActivity(*clip, 1, progressSink));
+	}
+	state.SetItemsProcessed(state.iterations() * clip->size());
+}
+BENCHMARK(VoiceActivityDetection_detect)->Arg(16000)->Arg(44100)->Unit(benchmark::kMillisecond);
+
+static void VoiceActivityDetection_detectLong(benchmark::State& state) {
+	const int threadCount = static_cast<int>(state.range(0));
+	const unique_ptr<AudioClip> clip = createSyllableClip(16000, 10 * 60);
+	NullProgressSink progressSink;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(detectVoiceActivity(*clip, threadCount, progressSink));
+	}
+	state.SetItemsProcessed(state.iterations() * clip->size());
+}
+BENCHMARK(VoiceActivityDetection_detectLong)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
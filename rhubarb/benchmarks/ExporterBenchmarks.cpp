@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <sstream>
+#include "exporters/TsvExporter.h"
+#include "exporters/XmlExporter.h"
+#include "exporters/JsonExporter.h"
+#include "exporters/DatExporter.h"
+
+using std::unique_ptr;
+using std::make_unique;
+
+// Returns a random animation of the specified length with 5 to 20 cs per shape
+JoiningContinuousTimeline<Shape> createAnimation(int seconds) {
+	const centiseconds duration(seconds * 100);
+	JoiningContinuousTimeline<Shape> animation(TimeRange(0_cs, duration), Shape::X);
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> shapeDistribution(
+		static_cast<int>(Shape::A),
+		static_cast<int>(Shape::X)
+	);
+	std::uniform_int_distribution<int> shapeDurationDistribution(5, 20);
+	for (centiseconds start = 0_cs; start < duration;) {
+		const centiseconds end = start + centiseconds(shapeDurationDistribution(random));
+		animation.set(start, end, static_cast<Shape>(shapeDistribution(random)));
+		start = end;
+	}
+	return animation;
+}
+
+template<typename TExporter>
+unique_ptr<Exporter> createBenchmarkExporter(const ShapeSet&) {
+	return make_unique<TExporter>();
+}
+
+template<>
+unique_ptr<Exporter> createBenchmarkExporter<DatExporter>(const ShapeSet& targetShapeSet) {
+	return make_unique<DatExporter>(targetShapeSet, 24.0, false);
+}
+
+template<typename TExporter>
+static void Exporter_exportAnimation(benchmark::State& state) {
+	// Basic shapes only, which is the default
+	const ShapeSet targetShapeSet = ShapeConverter::get().getBasicShapes();
+	const ExporterInput input("riddle.wav", createAnimation(60), targetShapeSet);
+	const unique_ptr<Exporter> exporter = createBenchmarkExporter<TExporter>(targetShapeSet);
+	for (auto _ : state) {
+		std::ostringstream stream;
+		exporter->exportAnimation(input, stream);
+		benchmark::DoNotOptimize(stream.str());
+	}
+	state.SetItemsProcessed(state.iterations() * input.animation.size());
+}
+BENCHMARK_TEMPLATE(Exporter_exportAnimation, TsvExporter);
+BENCHMARK_TEMPLATE(Exporter_exportAnimation, XmlExporter);
+BENCHMARK_TEMPLATE(Exporter_exportAnimation, JsonExporter);
+BENCHMARK_TEMPLATE(Exporter_exportAnimation, DatExporter);
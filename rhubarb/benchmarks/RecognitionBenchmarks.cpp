@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "recognition/g2p.h"
+#include "recognition/languageModels.h"
+#include "recognition/PocketSphinxRecognizer.h"
+#include "recognition/PhoneticRecognizer.h"
+#include "recognition/pocketSphinxTools.h"
+#include "recognition/PronunciationDictionary.h"
+#include "lib/rhubarbLib.h"
+#include "tools/platformTools.h"
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::filesystem::path;
+
+const vector<string> sampleWords {
+	"rhubarb", "lip", "sync", "animation", "character", "mouth", "shape", "speech", "recognition",
+	"through", "thoroughly", "knight", "psychology", "queue", "xylophone", "whistle", "gnome",
+	"photograph", "unbelievable", "strengths"
+};
+
+// Returns a transcript-like word sequence. Word frequencies follow Zipf's law, with a vocabulary
+// growing with the length of the transcript.
+vector<string> createTranscript(int wordCount) {
+	const int vocabularySize = std::max(20, wordCount / 4);
+	vector<double> weights;
+	for (int rank = 1; rank <= vocabularySize; ++rank) {
+		weights.push_back(1.0 / rank);
+	}
+	std::mt19937 random(0);
+	std::discrete_distribution<int> wordDistribution(weights.begin(), weights.end());
+	vector<string> words { "<s>" };
+	for (int i = 0; i < wordCount; ++i) {
+		words.push_back("word" + std::to_string(wordDistribution(random)));
+	}
+	words.emplace_back("</s>");
+	return words;
+}
+
+static void g2p_wordToPhones(benchmark::State& state) {
+	for (auto _ : state) {
+		for (const string& word : sampleWords) {
+			benchmark::DoNotOptimize(wordToPhones(word));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * sampleWords.size());
+}
+BENCHMARK(g2p_wordToPhones);
+
+// Returns every n-th word of the PocketSphinx dictionary that G2P accepts
+vector<string> loadDictionaryWords(int stride) {
+	std::ifstream file(getSphinxModelDirectory() / "cmudict-en-us.dict");
+	vector<string> words;
+	string line;
+	for (int i = 0; std::getline(file, line); ++i) {
+		const string word = line.substr(0, line.find(' '));
+		const bool isValid = !word.empty()
+			&& word.find_first_not_of("abcdefghijklmnopqrstuvwxyz'") == string::npos;
+		if (isValid && i % stride == 0) {
+			words.push_back(word);
+		}
+	}
+	return words;
+}
+
+static void g2p_wordToPhones_dictionary(benchmark::State& state) {
+	const vector<string> words = loadDictionaryWords(10);
+	if (words.empty()) {
+		state.SkipWithError("Dictionary not found.");
+		return;
+	}
+	for (auto _ : state) {
+		for (const string& word : words) {
+			benchmark::DoNotOptimize(wordToPhones(word));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(g2p_wordToPhones_dictionary)->Unit(benchmark::kMillisecond);
+
+// Loads the pronunciation dictionary and looks up some words
+static void PronunciationDictionary_load(benchmark::State& state) {
+	const path filePath = getSphinxModelDirectory() / "cmudict-en-us.bin";
+	try {
+		for (auto _ : state) {
+			const PronunciationDictionary dictionary(filePath);
+			for (const string& word : sampleWords) {
+				benchmark::DoNotOptimize(dictionary.find(word));
+			}
+		}
+	} catch (const std::exception& e) {
+		state.SkipWithError(e.what());
+	}
+}
+BENCHMARK(PronunciationDictionary_load)->Unit(benchmark::kMicrosecond);
+
+static void LanguageModels_estimateLanguageModel(benchmark::State& state) {
+	const vector<string> words = createTranscript(static_cast<int>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(estimateLanguageModel(words));
+	}
+	state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK(LanguageModels_estimateLanguageModel)
+	->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Animates a recording from start to finish, including model loading
+template<typename TRecognizer>
+static void Recognition_animateWaveFile(benchmark::State& state) {
+	const path filePath = getBinDirectory() / "benchmarks/resources/riddle.wav";
+	const int maxThreadCount = static_cast<int>(state.range(0));
+	// Basic shapes only, which is the default
+	const ShapeSet targetShapeSet = ShapeConverter::get().getBasicShapes();
+	NullProgressSink progressSink;
+	try {
+		for (auto _ : state) {
+			const TRecognizer recognizer;
+			benchmark::DoNotOptimize(animateWaveFile(
+				filePath, boost::none, recognizer, targetShapeSet, maxThreadCount, progressSink
+			));
+		}
+	} catch (const std::exception& e) {
+		state.SkipWithError(e.what());
+	}
+}
+BENCHMARK_TEMPLATE(Recognition_animateWaveFile, PocketSphinxRecognizer)
+	->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(Recognition_animateWaveFile, PhoneticRecognizer)
+	->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+class PhoneticDraftRecognizer : public PhoneticRecognizer {
+public:
+	PhoneticDraftRecognizer() :
+		PhoneticRecognizer(defaultMaxUtteranceLength, PhoneticQuality::Draft)
+	{}
+};
+BENCHMARK_TEMPLATE(Recognition_animateWaveFile, PhoneticDraftRecognizer)
+	->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
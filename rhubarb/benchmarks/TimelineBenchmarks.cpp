@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include "time/ContinuousTimeline.h"
+
+// Typical animation timelines have a few hundred to a few thousand elements
+#define TIMELINE_SIZES RangeMultiplier(8)->Range(64, 4096)
+
+// Returns a timeline with `size` adjacent elements of alternating value, 5 cs each
+ContinuousTimeline<int> createTimeline(int size) {
+	ContinuousTimeline<int> timeline(TimeRange(0_cs, centiseconds(size * 5)), 0);
+	for (int i = 0; i < size; ++i) {
+		timeline.set(centiseconds(i * 5), centiseconds(i * 5 + 5), i % 2 + 1);
+	}
+	return timeline;
+}
+
+// Builds a timeline in chronological order, as most processing steps do
+static void Timeline_setSequential(benchmark::State& state) {
+	const int size = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(createTimeline(size));
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(Timeline_setSequential)->TIMELINE_SIZES;
+
+// Overwrites random short ranges of a copied timeline, as tweening and retiming do
+static void Timeline_setRandom(benchmark::State& state) {
+	const int size = static_cast<int>(state.range(0));
+	const ContinuousTimeline<int> original = createTimeline(size);
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> startDistribution(0, size * 5 - 10);
+	std::uniform_int_distribution<int> durationDistribution(1, 10);
+	for (auto _ : state) {
+		ContinuousTimeline<int> timeline(original);
+		for (int i = 0; i < size; ++i) {
+			const centiseconds start(startDistribution(random));
+			timeline.set(start, start + centiseconds(durationDistribution(random)), 3);
+		}
+		benchmark::DoNotOptimize(timeline);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(Timeline_setRandom)->TIMELINE_SIZES;
+
+static void Timeline_find(benchmark::State& state) {
+	const int size = static_cast<int>(state.range(0));
+	const ContinuousTimeline<int> timeline = createTimeline(size);
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> timeDistribution(0, size * 5 - 1);
+	for (auto _ : state) {
+		const centiseconds time(timeDistribution(random));
+		benchmark::DoNotOptimize(timeline.find(time));
+		benchmark::DoNotOptimize(timeline.find(time, FindMode::SearchLeft));
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(Timeline_find)->TIMELINE_SIZES;
+
+static void Timeline_copyAndShift(benchmark::State& state) {
+	const int size = static_cast<int>(state.range(0));
+	const ContinuousTimeline<int> original = createTimeline(size);
+	for (auto _ : state) {
+		ContinuousTimeline<int> timeline(original);
+		timeline.shift(1_cs);
+		benchmark::DoNotOptimize(timeline);
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(Timeline_copyAndShift)->TIMELINE_SIZES;
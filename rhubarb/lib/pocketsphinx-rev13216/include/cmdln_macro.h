@@ -236,6 +236,10 @@
       ARG_BOOLEAN,									\
       "no",										\
       "Perform phoneme decoding with phonetic lm and context-independent units only" }, \
+{ "-allphone_bg",									\
+      ARG_BOOLEAN,									\
+      "no",										\
+      "Score phoneme decoding with the bigrams of the phonetic lm only (added for Rhubarb Lip Sync)" }, \
 { "-lm",										\
       ARG_STRING,									\
       NULL,										\
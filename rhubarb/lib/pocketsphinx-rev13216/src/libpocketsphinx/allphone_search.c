@@ -416,7 +416,8 @@ phmm_exit(allphone_search_t * allphs, int32 best)
                             history_t *pred =
                                 blkarray_list_get(history, h->hist);
 
-                            if (pred->hist > 0) {
+                            /* Modified for Rhubarb Lip Sync: optionally bigrams only */
+                            if (pred->hist > 0 && !allphs->bg_only) {
                                 history_t *pred_pred =
                                     blkarray_list_get(history,
                                                       h->hist);
@@ -492,7 +493,8 @@ phmm_trans(allphone_search_t * allphs, int32 best,
                 tscore = allphs->inspen;
             else {
                 int32 n_used;
-                if (h->hist > 0) {
+                /* Modified for Rhubarb Lip Sync: optionally bigrams only */
+                if (h->hist > 0 && !allphs->bg_only) {
                     history_t *pred =
                         blkarray_list_get(allphs->history, h->hist);
                     tscore =
@@ -542,6 +544,8 @@ allphone_search_init(const char *name,
     }
 
     allphs->ci_only = cmd_ln_boolean_r(config, "-allphone_ci");
+    /* Added for Rhubarb Lip Sync */
+    allphs->bg_only = cmd_ln_boolean_r(config, "-allphone_bg");
     allphs->lw = cmd_ln_float32_r(config, "-lw");
 
     phmm_build(allphs);
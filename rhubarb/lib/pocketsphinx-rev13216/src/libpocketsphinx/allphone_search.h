@@ -113,6 +113,7 @@ typedef struct allphone_search_s {
     hmm_context_t *hmmctx;    /**< HMM context. */
     ngram_model_t *lm;        /**< Ngram model set */
     int32 ci_only; 	      /**< Use context-independent phones for decoding */
+    int32 bg_only;            /**< Use bigram scores only (added for Rhubarb Lip Sync) */
     phmm_t **ci_phmm;         /**< PHMM lists (for each CI phone) */
     int32 *ci2lmwid;          /**< Mapping of CI phones to LM word IDs */
 
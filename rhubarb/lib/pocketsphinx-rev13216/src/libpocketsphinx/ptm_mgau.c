@@ -42,6 +42,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <math.h>
+#include <float.h>
 #if defined(__ADSPBLACKFIN__)
 #elif !defined(_WIN32_WCE)
 #include <sys/types.h>
@@ -67,6 +68,13 @@ static ps_mgaufuncs_t ptm_mgau_funcs = {
     ptm_mgau_free             /* free */
 };
 
+/* Added for Rhubarb Lip Sync */
+#ifdef FIXED_POINT
+#define PTM_WORST_DENSITY INT_MIN
+#else
+#define PTM_WORST_DENSITY (-FLT_MAX)
+#endif
+
 #define COMPUTE_GMM_MAP(_idx)                           \
     diff[_idx] = obs[_idx] - mean[_idx];                \
     sqdiff[_idx] = MFCCMUL(diff[_idx], diff[_idx]);     \
@@ -151,80 +159,160 @@ insertion_sort_cb(ptm_topn_t **cur, ptm_topn_t *worst, ptm_topn_t *best,
     (*cur)->score = intd;
 }
 
+/* Modified for Rhubarb Lip Sync: evaluates densities in blocks using
+ * a SIMD kernel.  Likelihoods never increase from one dimension to
+ * the next and the threshold never decreases from one density to the
+ * next, so this selects exactly the same densities as evaluating them
+ * one by one. */
 static int
 eval_cb(ptm_mgau_t *s, int cb, int feat, mfcc_t *z)
 {
     ptm_topn_t *worst, *best, *topn;
-    mfcc_t *mean;
-    mfcc_t *var, *det, *detP, *detE;
-    int32 i, ceplen;
+    const mfcc_t *mean, *var, *det;
+    int32 i, b, ceplen;
 
     best = topn = s->f->topn[cb][feat];
     worst = topn + (s->max_topn - 1);
-    mean = s->g->mean[cb][feat][0];
-    var = s->g->var[cb][feat][0];
-    det = s->g->det[cb][feat];
-    detE = det + s->g->n_density;
+    mean = s->block_mean[cb][feat];
+    var = s->block_var[cb][feat];
+    det = s->block_det[cb][feat];
     ceplen = s->g->featlen[feat];
 
-    for (detP = det; detP < detE; ++detP) {
-        mfcc_t diff[4], sqdiff[4], compl[4]; /* diff, diff^2, component likelihood */
-        mfcc_t d, thresh;
-        mfcc_t *obs;
-        ptm_topn_t *cur;
-        int32 cw, j;
-
-        d = *detP;
-        thresh = (mfcc_t) worst->score; /* Avoid int-to-float conversions */
-        obs = z;
-        cw = (int)(detP - det);
-
-        /* Unroll the loop starting with the first dimension(s).  In
-         * theory this might be a bit faster if this Gaussian gets
-         * "knocked out" by C0. In practice not. */
-        for (j = 0; (j < ceplen % 4) && (d >= thresh); ++j) {
-            diff[0] = *obs++ - *mean++;
-            sqdiff[0] = MFCCMUL(diff[0], diff[0]);
-            compl[0] = MFCCMUL(sqdiff[0], *var++);
-            d = GMMSUB(d, compl[0]);
-        }
-        /* Now do 4 dimensions at a time.  You'd think that GCC would
-         * vectorize this?  Apparently not.  And it's right, because
-         * that won't make this any faster, at least on x86-64. */
-        for (; j < ceplen && d >= thresh; j += 4) {
-            COMPUTE_GMM_MAP(0);
-            COMPUTE_GMM_MAP(1);
-            COMPUTE_GMM_MAP(2);
-            COMPUTE_GMM_MAP(3);
-            COMPUTE_GMM_REDUCE(0);
-            COMPUTE_GMM_REDUCE(1);
-            COMPUTE_GMM_REDUCE(2);
-            COMPUTE_GMM_REDUCE(3);
-            var += 4;
-            obs += 4;
-            mean += 4;
-        }
-        if (j < ceplen) {
-            /* terminated early, so not in topn */
-            mean += (ceplen - j);
-            var += (ceplen - j);
-            continue;
-        }
-        if (d < thresh)
-            continue;
-        for (i = 0; i < s->max_topn; i++) {
-            /* already there, so don't need to insert */
-            if (topn[i].cw == cw)
-                break;
+    for (b = 0; b < s->n_block; ++b) {
+        mfcc_t d[PTM_BLOCK_WIDTH];
+        int32 lane;
+
+        if (s->eval_block(mean, var, det, z, ceplen,
+                          (mfcc_t) worst->score, d)) {
+            for (lane = 0; lane < PTM_BLOCK_WIDTH; ++lane) {
+                ptm_topn_t *cur;
+                int32 cw = b * PTM_BLOCK_WIDTH + lane;
+
+                if (cw >= s->g->n_density)
+                    break;
+                /* Inserting densities raises the threshold */
+                if (d[lane] < (mfcc_t) worst->score)
+                    continue;
+                for (i = 0; i < s->max_topn; i++) {
+                    /* already there, so don't need to insert */
+                    if (topn[i].cw == cw)
+                        break;
+                }
+                if (i < s->max_topn)
+                    continue;       /* already there.  Don't insert */
+                insertion_sort_cb(&cur, worst, best, cw, (int32)d[lane]);
+            }
         }
-        if (i < s->max_topn)
-            continue;       /* already there.  Don't insert */
-        insertion_sort_cb(&cur, worst, best, cw, (int32)d);
+        mean += ceplen * PTM_BLOCK_WIDTH;
+        var += ceplen * PTM_BLOCK_WIDTH;
+        det += PTM_BLOCK_WIDTH;
     }
 
     return best->score;
 }
 
+/* Added for Rhubarb Lip Sync: returns the cache entry of codebook cb
+ * in the given frame, or NULL if there is none.  An entry holds the
+ * top-N codewords before evaluation (the seed), followed by those after
+ * evaluation. */
+static ptm_topn_t *
+topn_cache_get(ptm_mgau_t *s, int frame, int cb)
+{
+    size_t cache_idx;
+
+    if (frame >= s->n_topn_cache_alloc)
+        return NULL;
+    cache_idx = (size_t)frame * s->g->n_mgau + cb;
+    if (!s->topn_cache_valid[cache_idx])
+        return NULL;
+    return s->topn_cache + cache_idx * 2 * s->g->n_feat * s->max_topn;
+}
+
+/* Added for Rhubarb Lip Sync: copies the cached top-N codewords of
+ * codebook cb into the current frame, if available.  eval_cb() starts
+ * from the top-N codewords carried over from the previous frame and
+ * re-scored by eval_topn(), and its result depends on them.  So the
+ * cached result is only used if it was computed from the same seed. */
+static int
+topn_cache_replay(ptm_mgau_t *s, int frame, int cb)
+{
+    ptm_topn_t *cached;
+    size_t n_topn;
+
+    if (s->topn_cache_mode != PTM_TOPN_CACHE_REPLAY)
+        return FALSE;
+    if ((cached = topn_cache_get(s, frame, cb)) == NULL)
+        return FALSE;
+    n_topn = (size_t)s->g->n_feat * s->max_topn;
+    if (memcmp(cached, s->f->topn[cb][0], n_topn * sizeof(ptm_topn_t)) != 0)
+        return FALSE;
+    memcpy(s->f->topn[cb][0], cached + n_topn, n_topn * sizeof(ptm_topn_t));
+    return TRUE;
+}
+
+/* Added for Rhubarb Lip Sync: records the top-N codewords of codebook
+ * cb in the current frame before evaluation, invalidating the entry
+ * until topn_cache_record() completes it. */
+static void
+topn_cache_record_seed(ptm_mgau_t *s, int frame, int cb)
+{
+    size_t cache_idx, n_topn;
+
+    if (s->topn_cache_mode != PTM_TOPN_CACHE_RECORD)
+        return;
+    n_topn = (size_t)s->g->n_feat * s->max_topn;
+    if (frame >= s->n_topn_cache_alloc) {
+        int32 n_alloc = s->n_topn_cache_alloc ? s->n_topn_cache_alloc : 256;
+        while (frame >= n_alloc)
+            n_alloc *= 2;
+        s->topn_cache = ckd_realloc(s->topn_cache,
+                                    (size_t)n_alloc * s->g->n_mgau * 2 * n_topn
+                                    * sizeof(*s->topn_cache));
+        s->topn_cache_valid = ckd_realloc(s->topn_cache_valid,
+                                          (size_t)n_alloc * s->g->n_mgau
+                                          * sizeof(*s->topn_cache_valid));
+        memset(s->topn_cache_valid + (size_t)s->n_topn_cache_alloc * s->g->n_mgau, 0,
+               (size_t)(n_alloc - s->n_topn_cache_alloc) * s->g->n_mgau);
+        s->n_topn_cache_alloc = n_alloc;
+    }
+    cache_idx = (size_t)frame * s->g->n_mgau + cb;
+    memcpy(s->topn_cache + cache_idx * 2 * n_topn, s->f->topn[cb][0],
+           n_topn * sizeof(ptm_topn_t));
+    s->topn_cache_valid[cache_idx] = FALSE;
+}
+
+/* Added for Rhubarb Lip Sync: records the top-N codewords of codebook
+ * cb in the current frame after evaluation. */
+static void
+topn_cache_record(ptm_mgau_t *s, int frame, int cb)
+{
+    size_t cache_idx, n_topn;
+
+    if (s->topn_cache_mode != PTM_TOPN_CACHE_RECORD)
+        return;
+    n_topn = (size_t)s->g->n_feat * s->max_topn;
+    cache_idx = (size_t)frame * s->g->n_mgau + cb;
+    memcpy(s->topn_cache + cache_idx * 2 * n_topn + n_topn, s->f->topn[cb][0],
+           n_topn * sizeof(ptm_topn_t));
+    s->topn_cache_valid[cache_idx] = TRUE;
+}
+
+ptm_mgau_t *
+ptm_mgau_get(ps_mgau_t *ps)
+{
+    return ps->vt == &ptm_mgau_funcs ? (ptm_mgau_t *)ps : NULL;
+}
+
+void
+ptm_mgau_set_topn_cache_mode(ptm_mgau_t *s, ptm_topn_cache_mode_t mode)
+{
+    if (mode == PTM_TOPN_CACHE_RECORD && s->n_topn_cache_alloc > 0) {
+        memset(s->topn_cache_valid, 0,
+               (size_t)s->n_topn_cache_alloc * s->g->n_mgau);
+    }
+    s->topn_cache_mode = mode;
+}
+
 /**
  * Compute top-N densities for active codebooks (and prune)
  */
@@ -246,9 +334,15 @@ ptm_mgau_codebook_eval(ptm_mgau_t *s, mfcc_t **z, int frame)
     for (i = 0; i < s->g->n_mgau; ++i) {
         if (bitvec_is_clear(s->f->mgau_active, i))
             continue;
+        /* Added for Rhubarb Lip Sync */
+        if (topn_cache_replay(s, frame, i))
+            continue;
+        topn_cache_record_seed(s, frame, i);
         for (j = 0; j < s->g->n_feat; ++j) {
             eval_cb(s, i, j, z[j]);
         }
+        /* Added for Rhubarb Lip Sync */
+        topn_cache_record(s, frame, i);
     }
     return 0;
 }
@@ -766,6 +860,53 @@ read_mixw(ptm_mgau_t * s, char const *file_name, double SmoothMin)
     return n_sen;
 }
 
+/* Added for Rhubarb Lip Sync: copies the densities into the
+ * transposed block layout expected by the SIMD kernels. */
+static void
+build_density_blocks(ptm_mgau_t *s)
+{
+    gauden_t *g = s->g;
+    int32 cb, f, k, j, n_padded;
+    mfcc_t *p;
+
+    s->n_block = (g->n_density + PTM_BLOCK_WIDTH - 1) / PTM_BLOCK_WIDTH;
+    n_padded = s->n_block * PTM_BLOCK_WIDTH;
+    if (s->block_data == NULL) {
+        size_t size = 0;
+        for (f = 0; f < g->n_feat; ++f)
+            size += (size_t)n_padded * (2 * g->featlen[f] + 1);
+        s->block_data = ckd_calloc(size * g->n_mgau, sizeof(mfcc_t));
+        s->block_mean = ckd_calloc_2d(g->n_mgau, g->n_feat, sizeof(mfcc_t *));
+        s->block_var = ckd_calloc_2d(g->n_mgau, g->n_feat, sizeof(mfcc_t *));
+        s->block_det = ckd_calloc_2d(g->n_mgau, g->n_feat, sizeof(mfcc_t *));
+    }
+
+    p = s->block_data;
+    for (cb = 0; cb < g->n_mgau; ++cb) {
+        for (f = 0; f < g->n_feat; ++f) {
+            int32 ceplen = g->featlen[f];
+            s->block_mean[cb][f] = p;
+            p += n_padded * ceplen;
+            s->block_var[cb][f] = p;
+            p += n_padded * ceplen;
+            s->block_det[cb][f] = p;
+            p += n_padded;
+
+            for (k = 0; k < n_padded; ++k) {
+                size_t base = (size_t)(k / PTM_BLOCK_WIDTH) * ceplen * PTM_BLOCK_WIDTH
+                    + k % PTM_BLOCK_WIDTH;
+                for (j = 0; j < ceplen; ++j) {
+                    size_t idx = base + (size_t)j * PTM_BLOCK_WIDTH;
+                    /* Padding densities can never reach the threshold */
+                    s->block_mean[cb][f][idx] = k < g->n_density ? g->mean[cb][f][k][j] : 0;
+                    s->block_var[cb][f][idx] = k < g->n_density ? g->var[cb][f][k][j] : 0;
+                }
+                s->block_det[cb][f][k] = k < g->n_density ? g->det[cb][f][k] : PTM_WORST_DENSITY;
+            }
+        }
+    }
+}
+
 ps_mgau_t *
 ptm_mgau_init(acmod_t *acmod, bin_mdef_t *mdef)
 {
@@ -833,6 +974,10 @@ ptm_mgau_init(acmod_t *acmod, bin_mdef_t *mdef)
             goto error_out;
         }
     }
+    /* Added for Rhubarb Lip Sync */
+    build_density_blocks(s);
+    s->eval_block = ptm_eval_block_select();
+
     s->ds_ratio = cmd_ln_int32_r(s->config, "-ds");
     s->max_topn = cmd_ln_int32_r(s->config, "-topn");
     E_INFO("Maximum top-N: %d\n", s->max_topn);
@@ -884,7 +1029,11 @@ ptm_mgau_mllr_transform(ps_mgau_t *ps,
                             ps_mllr_t *mllr)
 {
     ptm_mgau_t *s = (ptm_mgau_t *)ps;
-    return gauden_mllr_transform(s->g, mllr, s->config);
+    int rv = gauden_mllr_transform(s->g, mllr, s->config);
+    /* Added for Rhubarb Lip Sync */
+    if (rv == 0)
+        build_density_blocks(s);
+    return rv;
 }
 
 void
@@ -910,6 +1059,14 @@ ptm_mgau_free(ps_mgau_t *ps)
     }
     ckd_free(s->hist);
     
+    /* Added for Rhubarb Lip Sync */
+    ckd_free(s->topn_cache);
+    ckd_free(s->topn_cache_valid);
+    ckd_free(s->block_data);
+    ckd_free_2d(s->block_mean);
+    ckd_free_2d(s->block_var);
+    ckd_free_2d(s->block_det);
+
     gauden_free(s->g);
     ckd_free(s);
 }
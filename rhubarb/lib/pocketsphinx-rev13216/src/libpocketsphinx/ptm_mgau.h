@@ -52,6 +52,7 @@
 #include "hmm.h"
 #include "bin_mdef.h"
 #include "ms_gauden.h"
+#include "ptm_mgau_simd.h"
 
 typedef struct ptm_mgau_s ptm_mgau_t;
 
@@ -60,6 +61,17 @@ typedef struct ptm_topn_s {
     int32 score; /**< Score. */
 } ptm_topn_t;
 
+/**
+ * How codebook evaluations are cached across passes over an utterance.
+ *
+ * Added for Rhubarb Lip Sync.
+ */
+typedef enum ptm_topn_cache_mode_e {
+    PTM_TOPN_CACHE_OFF,    /**< Evaluate codebooks normally. */
+    PTM_TOPN_CACHE_RECORD, /**< Evaluate codebooks and record their top-N codewords. */
+    PTM_TOPN_CACHE_REPLAY  /**< Use recorded top-N codewords where the seed matches. */
+} ptm_topn_cache_mode_t;
+
 typedef struct ptm_fast_eval_s {
     ptm_topn_t ***topn;     /**< Top-N for each codebook (mgau x feature x topn) */
     bitvec_t *mgau_active; /**< Set of active codebooks */
@@ -85,9 +97,43 @@ struct ptm_mgau_s {
     logmath_t *lmath_8b;
     /* Log-add object for reloading means/variances. */
     logmath_t *lmath;
+
+    /* Added for Rhubarb Lip Sync: densities transposed into blocks for
+     * SIMD evaluation (see ptm_mgau_simd.h). */
+    int32 n_block;           /**< Number of density blocks per codebook and feature. */
+    mfcc_t ***block_mean;    /**< Transposed means by codebook and feature. */
+    mfcc_t ***block_var;     /**< Transposed variances by codebook and feature. */
+    mfcc_t ***block_det;     /**< Padded determinants by codebook and feature. */
+    mfcc_t *block_data;      /**< Storage for the above. */
+    ptm_eval_block_func_t eval_block; /**< Fastest block kernel for this CPU. */
+
+    /* Added for Rhubarb Lip Sync: top-N codewords of each frame of the
+     * utterance, before normalization.  Evaluating a codebook starts
+     * from the top-N codewords carried over from the previous frame, so
+     * each entry also records that seed.  A second pass over the
+     * utterance reuses an entry only if its seed is the same. */
+    ptm_topn_cache_mode_t topn_cache_mode;
+    ptm_topn_t *topn_cache;   /**< Seed and top-N by frame, codebook, feature */
+    uint8 *topn_cache_valid;  /**< Whether cached, by frame and codebook */
+    int32 n_topn_cache_alloc; /**< Number of frames allocated */
 };
 
 ps_mgau_t *ptm_mgau_init(acmod_t *acmod, bin_mdef_t *mdef);
+
+/**
+ * Returns the model as PTM model, or NULL if it is of a different type.
+ *
+ * Added for Rhubarb Lip Sync.
+ */
+ptm_mgau_t *ptm_mgau_get(ps_mgau_t *ps);
+
+/**
+ * Sets how codebook evaluations are cached.  Switching to
+ * PTM_TOPN_CACHE_RECORD discards the previous recording.
+ *
+ * Added for Rhubarb Lip Sync.
+ */
+void ptm_mgau_set_topn_cache_mode(ptm_mgau_t *s, ptm_topn_cache_mode_t mode);
 void ptm_mgau_free(ps_mgau_t *s);
 int ptm_mgau_frame_eval(ps_mgau_t *s,
                         int16 *senone_scores,
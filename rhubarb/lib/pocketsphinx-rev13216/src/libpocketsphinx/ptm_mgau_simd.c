@@ -0,0 +1,162 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/**
+ * @file ptm_mgau_simd.c Vectorized codebook evaluation for PTM models.
+ *
+ * Added for Rhubarb Lip Sync.
+ *
+ * None of the kernels may use fused multiply-add, since that would
+ * change the rounding compared to the scalar code.  For the same
+ * reason, this file and ptm_mgau.c are compiled with
+ * -ffp-contract=off, which keeps the compiler from fusing the
+ * separate multiplications and subtractions on its own.
+ *
+ * The wide x86 kernel only needs AVX, not AVX2: it uses nothing but
+ * 256-bit float arithmetic, which AVX already provides.  AVX2 adds
+ * integer and gather instructions this code has no use for, and its
+ * FMA companion is ruled out above.
+ */
+
+#include "ptm_mgau_simd.h"
+#include "tied_mgau_common.h"
+
+#if defined(PTM_HAVE_SSE2) || defined(PTM_HAVE_AVX)
+#include <immintrin.h>
+#endif
+#ifdef PTM_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+int
+ptm_eval_block_c(const mfcc_t *mean, const mfcc_t *var,
+                 const mfcc_t *det, const mfcc_t *obs,
+                 int32 ceplen, mfcc_t thresh, mfcc_t *out)
+{
+    int32 i, j;
+    int any_above = 0;
+
+    for (i = 0; i < PTM_BLOCK_WIDTH; ++i) {
+        mfcc_t d = det[i];
+        for (j = 0; j < ceplen; ++j) {
+            mfcc_t diff = obs[j] - mean[j * PTM_BLOCK_WIDTH + i];
+            mfcc_t sqdiff = MFCCMUL(diff, diff);
+            mfcc_t compl = MFCCMUL(sqdiff, var[j * PTM_BLOCK_WIDTH + i]);
+            d = GMMSUB(d, compl);
+        }
+        out[i] = d;
+        if (d >= thresh)
+            any_above = 1;
+    }
+    return any_above;
+}
+
+#ifdef PTM_HAVE_SSE2
+int
+ptm_eval_block_sse2(const mfcc_t *mean, const mfcc_t *var,
+                    const mfcc_t *det, const mfcc_t *obs,
+                    int32 ceplen, mfcc_t thresh, mfcc_t *out)
+{
+    __m128 d0 = _mm_loadu_ps(det);
+    __m128 d1 = _mm_loadu_ps(det + 4);
+    __m128 t = _mm_set1_ps(thresh);
+    int32 j;
+
+    for (j = 0; j < ceplen; ++j) {
+        __m128 o = _mm_set1_ps(obs[j]);
+        __m128 diff0 = _mm_sub_ps(o, _mm_loadu_ps(mean));
+        __m128 diff1 = _mm_sub_ps(o, _mm_loadu_ps(mean + 4));
+        __m128 compl0 = _mm_mul_ps(_mm_mul_ps(diff0, diff0), _mm_loadu_ps(var));
+        __m128 compl1 = _mm_mul_ps(_mm_mul_ps(diff1, diff1), _mm_loadu_ps(var + 4));
+        d0 = _mm_sub_ps(d0, compl0);
+        d1 = _mm_sub_ps(d1, compl1);
+        /* Likelihoods only decrease, so stop once all are below thresh. */
+        if (!_mm_movemask_ps(_mm_or_ps(_mm_cmpge_ps(d0, t), _mm_cmpge_ps(d1, t))))
+            return 0;
+        mean += PTM_BLOCK_WIDTH;
+        var += PTM_BLOCK_WIDTH;
+    }
+    _mm_storeu_ps(out, d0);
+    _mm_storeu_ps(out + 4, d1);
+    return 1;
+}
+#endif
+
+#ifdef PTM_HAVE_AVX
+__attribute__((target("avx"))) int
+ptm_eval_block_avx(const mfcc_t *mean, const mfcc_t *var,
+                   const mfcc_t *det, const mfcc_t *obs,
+                   int32 ceplen, mfcc_t thresh, mfcc_t *out)
+{
+    __m256 d = _mm256_loadu_ps(det);
+    __m256 t = _mm256_set1_ps(thresh);
+    int32 j;
+
+    for (j = 0; j < ceplen; ++j) {
+        __m256 diff = _mm256_sub_ps(_mm256_set1_ps(obs[j]), _mm256_loadu_ps(mean));
+        __m256 compl = _mm256_mul_ps(_mm256_mul_ps(diff, diff), _mm256_loadu_ps(var));
+        d = _mm256_sub_ps(d, compl);
+        if (!_mm256_movemask_ps(_mm256_cmp_ps(d, t, _CMP_GE_OQ)))
+            return 0;
+        mean += PTM_BLOCK_WIDTH;
+        var += PTM_BLOCK_WIDTH;
+    }
+    _mm256_storeu_ps(out, d);
+    return 1;
+}
+#endif
+
+#ifdef PTM_HAVE_NEON
+int
+ptm_eval_block_neon(const mfcc_t *mean, const mfcc_t *var,
+                    const mfcc_t *det, const mfcc_t *obs,
+                    int32 ceplen, mfcc_t thresh, mfcc_t *out)
+{
+    float32x4_t d0 = vld1q_f32(det);
+    float32x4_t d1 = vld1q_f32(det + 4);
+    float32x4_t t = vdupq_n_f32(thresh);
+    int32 j;
+
+    for (j = 0; j < ceplen; ++j) {
+        float32x4_t o = vdupq_n_f32(obs[j]);
+        float32x4_t diff0 = vsubq_f32(o, vld1q_f32(mean));
+        float32x4_t diff1 = vsubq_f32(o, vld1q_f32(mean + 4));
+        float32x4_t compl0 = vmulq_f32(vmulq_f32(diff0, diff0), vld1q_f32(var));
+        float32x4_t compl1 = vmulq_f32(vmulq_f32(diff1, diff1), vld1q_f32(var + 4));
+        d0 = vsubq_f32(d0, compl0);
+        d1 = vsubq_f32(d1, compl1);
+        if (vmaxvq_u32(vorrq_u32(vcgeq_f32(d0, t), vcgeq_f32(d1, t))) == 0)
+            return 0;
+        mean += PTM_BLOCK_WIDTH;
+        var += PTM_BLOCK_WIDTH;
+    }
+    vst1q_f32(out, d0);
+    vst1q_f32(out + 4, d1);
+    return 1;
+}
+#endif
+
+int
+ptm_avx_supported(void)
+{
+#ifdef PTM_HAVE_AVX
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx");
+#else
+    return 0;
+#endif
+}
+
+ptm_eval_block_func_t
+ptm_eval_block_select(void)
+{
+#ifdef PTM_HAVE_AVX
+    if (ptm_avx_supported())
+        return ptm_eval_block_avx;
+#endif
+#if defined(PTM_HAVE_SSE2)
+    return ptm_eval_block_sse2;
+#elif defined(PTM_HAVE_NEON)
+    return ptm_eval_block_neon;
+#else
+    return ptm_eval_block_c;
+#endif
+}
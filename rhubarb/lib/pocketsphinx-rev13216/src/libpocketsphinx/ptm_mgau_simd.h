@@ -0,0 +1,81 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/**
+ * @file ptm_mgau_simd.h Vectorized codebook evaluation for PTM models.
+ *
+ * Added for Rhubarb Lip Sync.
+ *
+ * The kernels evaluate a block of PTM_BLOCK_WIDTH densities at once,
+ * one density per lane.  Each lane performs exactly the same
+ * floating-point operations in the same order as the scalar code in
+ * ptm_mgau.c, so all kernels produce bit-identical results.
+ *
+ * Densities are stored transposed: mean[j * PTM_BLOCK_WIDTH + lane]
+ * is dimension j of the lane's density.
+ */
+
+#ifndef __PTM_MGAU_SIMD_H__
+#define __PTM_MGAU_SIMD_H__
+
+#include <sphinxbase/fe.h>
+#include <sphinxbase/prim_type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PTM_BLOCK_WIDTH 8
+
+/**
+ * Computes the log likelihoods of a block of densities.
+ *
+ * @param mean Transposed means (ceplen * PTM_BLOCK_WIDTH)
+ * @param var Transposed precomputed variances (ceplen * PTM_BLOCK_WIDTH)
+ * @param det Precomputed determinants (PTM_BLOCK_WIDTH)
+ * @param obs Observation vector (ceplen)
+ * @param thresh Pruning threshold
+ * @param out Receives the log likelihoods (PTM_BLOCK_WIDTH)
+ * @return 0 if all densities fell below thresh, in which case out is
+ *         undefined; nonzero otherwise.
+ */
+typedef int (*ptm_eval_block_func_t)(const mfcc_t *mean, const mfcc_t *var,
+                                     const mfcc_t *det, const mfcc_t *obs,
+                                     int32 ceplen, mfcc_t thresh, mfcc_t *out);
+
+/** Portable reference implementation. */
+int ptm_eval_block_c(const mfcc_t *mean, const mfcc_t *var,
+                     const mfcc_t *det, const mfcc_t *obs,
+                     int32 ceplen, mfcc_t thresh, mfcc_t *out);
+
+#if !defined(FIXED_POINT) && (defined(__SSE2__) || defined(_M_X64))
+#define PTM_HAVE_SSE2
+int ptm_eval_block_sse2(const mfcc_t *mean, const mfcc_t *var,
+                        const mfcc_t *det, const mfcc_t *obs,
+                        int32 ceplen, mfcc_t thresh, mfcc_t *out);
+#endif
+
+#if !defined(FIXED_POINT) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define PTM_HAVE_AVX
+int ptm_eval_block_avx(const mfcc_t *mean, const mfcc_t *var,
+                       const mfcc_t *det, const mfcc_t *obs,
+                       int32 ceplen, mfcc_t thresh, mfcc_t *out);
+#endif
+
+#if !defined(FIXED_POINT) && (defined(__aarch64__) || defined(_M_ARM64))
+#define PTM_HAVE_NEON
+int ptm_eval_block_neon(const mfcc_t *mean, const mfcc_t *var,
+                        const mfcc_t *det, const mfcc_t *obs,
+                        int32 ceplen, mfcc_t thresh, mfcc_t *out);
+#endif
+
+/** Returns nonzero if the CPU supports the AVX kernel. */
+int ptm_avx_supported(void);
+
+/** Returns the fastest kernel supported by the CPU. */
+ptm_eval_block_func_t ptm_eval_block_select(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PTM_MGAU_SIMD_H__ */
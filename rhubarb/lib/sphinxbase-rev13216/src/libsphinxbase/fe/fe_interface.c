@@ -295,6 +295,10 @@ fe_init_auto_r(cmd_ln_t *config)
     /* create twiddle factors */
     fe->ccc = ckd_calloc(fe->fft_size / 4, sizeof(*fe->ccc));
     fe->sss = ckd_calloc(fe->fft_size / 4, sizeof(*fe->sss));
+    /* Added for Rhubarb Lip Sync */
+    fe->stage_ccc = ckd_calloc(fe->fft_size / 2, sizeof(*fe->stage_ccc));
+    fe->stage_sss = ckd_calloc(fe->fft_size / 2, sizeof(*fe->stage_sss));
+    fe->bitrev = ckd_calloc(fe->fft_size, sizeof(*fe->bitrev));
     fe_create_twiddle(fe);
 
     if (cmd_ln_boolean_r(config, "-verbose")) {
@@ -641,6 +645,9 @@ fe_free(fe_t * fe)
     if (fe->mel_fb) {
         if (fe->mel_fb->mel_cosine)
             fe_free_2d((void *) fe->mel_fb->mel_cosine);
+        /* Added for Rhubarb Lip Sync */
+        if (fe->mel_fb->mel_cosine_by_filter)
+            fe_free_2d((void *) fe->mel_fb->mel_cosine_by_filter);
         ckd_free(fe->mel_fb->lifter);
         ckd_free(fe->mel_fb->spec_start);
         ckd_free(fe->mel_fb->filt_start);
@@ -652,6 +659,10 @@ fe_free(fe_t * fe)
     ckd_free(fe->frame);
     ckd_free(fe->ccc);
     ckd_free(fe->sss);
+    /* Added for Rhubarb Lip Sync */
+    ckd_free(fe->stage_ccc);
+    ckd_free(fe->stage_sss);
+    ckd_free(fe->bitrev);
     ckd_free(fe->spec);
     ckd_free(fe->mfspec);
     ckd_free(fe->overflow_samps);
@@ -81,6 +81,9 @@ struct melfb_s {
     float32 upper_filt_freq;
     /* DCT coefficients. */
     mfcc_t **mel_cosine;
+    /* Added for Rhubarb Lip Sync: DCT coefficients by filter, then
+     * cepstrum, so that DCT-II can be vectorized over cepstra. */
+    mfcc_t **mel_cosine_by_filter;
     /* Filter coefficients. */
     mfcc_t *filt_coeffs;
     int16 *spec_start;
@@ -146,6 +149,11 @@ struct fe_s {
 
     /* Twiddle factors for FFT. */
     frame_t *ccc, *sss;
+    /* Added for Rhubarb Lip Sync: twiddle factors of each FFT stage,
+     * stored contiguously so the butterflies can be vectorized, and
+     * the bit-reversal permutation. */
+    frame_t *stage_ccc, *stage_sss;
+    int16 *bitrev;
     /* Mel filter parameters. */
     melfb_t *mel_fb;
     /* Half of a Hamming Window. */
@@ -706,6 +706,16 @@ fe_compute_melcosine(melfb_t * mel_fb)
         }
     }
 
+    /* Added for Rhubarb Lip Sync */
+    mel_fb->mel_cosine_by_filter =
+        (mfcc_t **) ckd_calloc_2d(mel_fb->num_filters,
+                                  mel_fb->num_cepstra, sizeof(mfcc_t));
+    for (i = 0; i < mel_fb->num_cepstra; i++) {
+        for (j = 0; j < mel_fb->num_filters; j++) {
+            mel_fb->mel_cosine_by_filter[j][i] = mel_fb->mel_cosine[i][j];
+        }
+    }
+
     /* Also precompute normalization constants for unitary DCT. */
     mel_fb->sqrt_inv_n = FLOAT2COS(sqrt(1.0 / mel_fb->num_filters));
     mel_fb->sqrt_inv_2n = FLOAT2COS(sqrt(2.0 / mel_fb->num_filters));
@@ -882,9 +892,69 @@ fe_create_twiddle(fe_t * fe)
         fe->sss[i] = sin(a);
 #endif
     }
+
+    /* Added for Rhubarb Lip Sync: stage k uses the twiddle factors
+     * at j << (m - k - 1) for 1 <= j < 2^(k-1).  Store them at
+     * 2^(k-1) + j. */
+    {
+        int k, j, m = fe->fft_order;
+        for (k = 1; k < m; ++k) {
+            for (j = 1; j < (1 << (k - 1)); ++j) {
+                fe->stage_ccc[(1 << (k - 1)) + j] = fe->ccc[j << (m - k - 1)];
+                fe->stage_sss[(1 << (k - 1)) + j] = fe->sss[j << (m - k - 1)];
+            }
+        }
+    }
+
+    /* Added for Rhubarb Lip Sync: bit-reversal permutation */
+    {
+        int j = 0, k;
+        for (i = 0; i < fe->fft_size; ++i) {
+            fe->bitrev[i] = j;
+            k = fe->fft_size / 2;
+            while (k >= 1 && k <= j) {
+                j -= k;
+                k /= 2;
+            }
+            j += k;
+        }
+    }
 }
 
 
+/*
+ * Added for Rhubarb Lip Sync: the butterflies with complex twiddle
+ * factors of one FFT stage, moved out of fe_fft_real() so that the
+ * compiler can vectorize them.  The four quarters don't overlap.  The
+ * second and fourth quarter are traversed backwards.  The arithmetic
+ * is the same as before.
+ */
+static void
+fe_fft_complex_butterflies(frame_t * __restrict x1, frame_t * __restrict x2,
+                           frame_t * __restrict x3, frame_t * __restrict x4,
+                           const frame_t * __restrict cc,
+                           const frame_t * __restrict ss, int count)
+{
+    int j;
+
+    for (j = 0; j < count; ++j) {
+        frame_t t1, t2, a, b;
+        int r = count - 1 - j;
+
+        /* There are some symmetry properties which allow us
+         * to get away with only four multiplications here. */
+        t1 = COSMUL(x3[j], cc[j]) + COSMUL(x4[r], ss[j]);
+        t2 = COSMUL(x3[j], ss[j]) - COSMUL(x4[r], cc[j]);
+
+        a = x1[j];
+        b = x2[r];
+        x4[r] = (b - t2);
+        x3[j] = (-b - t2);
+        x2[r] = (a - t1);
+        x1[j] = (a + t1);
+    }
+}
+
 static int
 fe_fft_real(fe_t * fe)
 {
@@ -895,20 +965,15 @@ fe_fft_real(fe_t * fe)
     m = fe->fft_order;
     n = fe->fft_size;
 
-    /* Bit-reverse the input. */
-    j = 0;
-    for (i = 0; i < n - 1; ++i) {
+    /* Bit-reverse the input.  Modified for Rhubarb Lip Sync to use
+     * a precomputed permutation. */
+    for (i = 0; i < n; ++i) {
+        j = fe->bitrev[i];
         if (i < j) {
             xt = x[j];
             x[j] = x[i];
             x[i] = xt;
         }
-        k = n / 2;
-        while (k <= j) {
-            j -= k;
-            k /= 2;
-        }
-        j += k;
     }
 
     /* Basic butterflies (2-point FFT, real twiddle factors):
@@ -948,34 +1013,14 @@ fe_fft_real(fe_t * fe)
             x[i + (1 << n4)] = x[i + (1 << n4)];
 
             /* Butterflies with complex twiddle factors.
-             * There are (1<<k-1) of them.
-             */
-            for (j = 1; j < (1 << n4); ++j) {
-                frame_t cc, ss, t1, t2;
-                int i1, i2, i3, i4;
-
-                i1 = i + j;
-                i2 = i + (1 << n2) - j;
-                i3 = i + (1 << n2) + j;
-                i4 = i + (1 << n2) + (1 << n2) - j;
-
-                /*
-                 * cc = real(W[j * n / (1<<(k+1))])
-                 * ss = imag(W[j * n / (1<<(k+1))])
-                 */
-                cc = fe->ccc[j << (m - n1)];
-                ss = fe->sss[j << (m - n1)];
-
-                /* There are some symmetry properties which allow us
-                 * to get away with only four multiplications here. */
-                t1 = COSMUL(x[i3], cc) + COSMUL(x[i4], ss);
-                t2 = COSMUL(x[i3], ss) - COSMUL(x[i4], cc);
-
-                x[i4] = (x[i2] - t2);
-                x[i3] = (-x[i2] - t2);
-                x[i2] = (x[i1] - t1);
-                x[i1] = (x[i1] + t1);
-            }
+             * There are (1<<k-1) of them. */
+            fe_fft_complex_butterflies(x + i + 1,
+                                       x + i + (1 << n4) + 1,
+                                       x + i + (1 << n2) + 1,
+                                       x + i + (1 << n2) + (1 << n4) + 1,
+                                       fe->stage_ccc + (1 << n4) + 1,
+                                       fe->stage_sss + (1 << n4) + 1,
+                                       (1 << n4) - 1);
         }
     }
 
@@ -1128,6 +1173,18 @@ fe_spec2cep(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep)
     }
 }
 
+/* Added for Rhubarb Lip Sync */
+static void
+fe_dct2_accumulate(mfcc_t * __restrict mfcep,
+                   const mfcc_t * __restrict cosine,
+                   powspec_t mflogspec, int32 count)
+{
+    int32 i;
+
+    for (i = 0; i < count; ++i)
+        mfcep[i] += COSMUL(mflogspec, cosine[i]);
+}
+
 void
 fe_dct2(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep, int htk)
 {
@@ -1143,13 +1200,17 @@ fe_dct2(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep, int htk)
     else                        /* sqrt(1/N) = sqrt(2/N) * 1/sqrt(2) */
         mfcep[0] = COSMUL(mfcep[0], fe->mel_fb->sqrt_inv_n);
 
-    for (i = 1; i < fe->num_cepstra; ++i) {
+    /* Modified for Rhubarb Lip Sync: loop over filters first, so
+     * that the compiler can vectorize over cepstra.  Each cepstrum
+     * still sums the filters in the same order. */
+    for (i = 1; i < fe->num_cepstra; ++i)
         mfcep[i] = 0;
-        for (j = 0; j < fe->mel_fb->num_filters; j++) {
-            mfcep[i] += COSMUL(mflogspec[j], fe->mel_fb->mel_cosine[i][j]);
-        }
-        mfcep[i] = COSMUL(mfcep[i], fe->mel_fb->sqrt_inv_2n);
+    for (j = 0; j < fe->mel_fb->num_filters; j++) {
+        fe_dct2_accumulate(mfcep + 1, fe->mel_fb->mel_cosine_by_filter[j] + 1,
+                           mflogspec[j], fe->num_cepstra - 1);
     }
+    for (i = 1; i < fe->num_cepstra; ++i)
+        mfcep[i] = COSMUL(mfcep[i], fe->mel_fb->sqrt_inv_2n);
 }
 
 void
@@ -228,6 +228,22 @@ ngram_model_trie_read_arpa(cmd_ln_t * config,
     return base;
 }
 
+ngram_model_t *
+ngram_model_trie_init(logmath_t * lmath, uint32 * counts, int order)
+{
+    ngram_model_trie_t *model;
+    ngram_model_t *base;
+
+    model = (ngram_model_trie_t *) ckd_calloc(1, sizeof(*model));
+    base = &model->base;
+    ngram_model_init(base, &ngram_model_trie_funcs, lmath, order,
+                     (int32) counts[0]);
+    base->writable = TRUE;
+    model->trie = lm_trie_create(counts[0], order);
+
+    return base;
+}
+
 int
 ngram_model_trie_write_arpa(ngram_model_t * base, const char *path)
 {
@@ -55,6 +55,15 @@ ngram_model_t *ngram_model_trie_read_arpa(cmd_ln_t * config,
                                           const char *path,
                                           logmath_t * lmath);
 
+/**
+ * Create an empty N-Gram model with a trie for the given n-gram counts.
+ * The caller fills in the unigrams and word strings, then calls lm_trie_build()
+ * for the higher-order n-grams.
+ * (Added for Rhubarb Lip Sync to build language models in memory.)
+ */
+ngram_model_t *ngram_model_trie_init(logmath_t * lmath, uint32 * counts,
+                                     int order);
+
 /**
  * Write N-Gram model stored in trie structure in ARPABO format
  */
@@ -2,6 +2,7 @@
 #include <boost/range/adaptor/transformed.hpp>
 #include <utility>
 #include "time/ContinuousTimeline.h"
+#include "tools/profiling.h"
 
 using boost::optional;
 using boost::adaptors::transformed;
@@ -49,6 +50,8 @@ bool ShapeRule::operator<(const ShapeRule& rhs) const {
 }
 
 ContinuousTimeline<ShapeRule> getShapeRules(const BoundedTimeline<Phone>& phones) {
+	profiling::ScopedTimer timer("shape rules");
+
 	// Convert to continuous timeline so that silences aren't skipped when iterating
 	auto continuousPhones = boundedTimelinetoContinuousOptional(phones);
 
@@ -0,0 +1,60 @@
+#include "StreamingAnimator.h"
+#include "mouthAnimation.h"
+#include "staticSegments.h"
+
+// Phones before the final part of the animation that are animated again for context.
+// The passes look back about as far as they look ahead. In addition, a static segment must be
+// seen in full to be recognized.
+constexpr centiseconds context = StreamingAnimator::lookahead + minStaticSegmentDuration;
+
+StreamingAnimator::StreamingAnimator(const ShapeSet& targetShapeSet) :
+	targetShapeSet(targetShapeSet)
+{}
+
+JoiningContinuousTimeline<Shape> StreamingAnimator::update(
+	const Timeline<Phone>& phones,
+	centiseconds completedTime
+) {
+	for (const auto& timedPhone : phones) {
+		this->phones.set(timedPhone);
+	}
+	return animateWindow(completedTime, completedTime - lookahead);
+}
+
+JoiningContinuousTimeline<Shape> StreamingAnimator::finish(
+	const Timeline<Phone>& phones,
+	centiseconds endTime
+) {
+	for (const auto& timedPhone : phones) {
+		this->phones.set(timedPhone);
+	}
+	return animateWindow(endTime, endTime);
+}
+
+JoiningContinuousTimeline<Shape> StreamingAnimator::animateWindow(
+	centiseconds windowEnd,
+	centiseconds finalEnd
+) {
+	const TimeRange finalRange(finalTime, std::max(finalTime, finalEnd));
+	JoiningContinuousTimeline<Shape> result(finalRange, Shape::X);
+	if (finalRange.empty()) return result;
+
+	// Animate the window
+	const TimeRange windowRange(std::max(0_cs, finalTime - context), windowEnd);
+	BoundedTimeline<Phone> windowPhones(windowRange);
+	for (const auto& timedPhone : phones) {
+		windowPhones.set(timedPhone);
+	}
+	for (const auto& timedShape : animate(windowPhones, targetShapeSet)) {
+		result.set(timedShape);
+	}
+
+	// Forget phones that won't be part of any future window
+	finalTime = finalRange.getEnd();
+	const centiseconds contextStart = finalTime - context;
+	if (!phones.empty() && phones.getRange().getStart() < contextStart) {
+		phones.clear(TimeRange(phones.getRange().getStart(), contextStart));
+	}
+
+	return result;
+}
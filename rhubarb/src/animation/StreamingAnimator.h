@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Phone.h"
+#include "core/Shape.h"
+#include "time/ContinuousTimeline.h"
+#include "targetShapeSet.h"
+#include "animationRules.h"
+#include "roughAnimation.h"
+#include "timingOptimization.h"
+#include "pauseAnimation.h"
+#include "tweening.h"
+
+// Animates phones that become known incrementally.
+// Each update re-animates a sliding window of recent phones. Shapes are final -- and returned --
+// once they are far enough from the end of the known phones that later phones can't affect them.
+// The one exception is static segment avoidance, which compares alternatives across the whole
+// window; it rarely makes streamed shapes differ from those of a single animate() call.
+class StreamingAnimator {
+public:
+	// How far the final animation lags behind the known phones.
+	// This is the sum of how far each animation pass lets a phone affect earlier shapes: plosives
+	// close the mouth early, vowels are anticipated, timing optimization brings segments forward
+	// and merges shapes within two minimal shape durations, a short pause depends on the shape
+	// after it, and tweens overlap the preceding shape.
+	static constexpr centiseconds lookahead = maxOcclusionDuration
+		+ maxAnticipationDuration
+		+ maxExtensionDuration + 2 * minShapeDuration
+		+ maxShortPauseDuration
+		+ maxTweenDuration;
+
+	explicit StreamingAnimator(const ShapeSet& targetShapeSet);
+
+	// Adds phones, all phones before completedTime being known.
+	// Returns the part of the animation that has become final.
+	JoiningContinuousTimeline<Shape> update(const Timeline<Phone>& phones, centiseconds completedTime);
+
+	// Adds the last phones and returns the remaining animation up to the specified end time
+	JoiningContinuousTimeline<Shape> finish(const Timeline<Phone>& phones, centiseconds endTime);
+
+private:
+	JoiningContinuousTimeline<Shape> animateWindow(centiseconds windowEnd, centiseconds finalEnd);
+
+	ShapeSet targetShapeSet;
+	Timeline<Phone> phones;
+	centiseconds finalTime = 0_cs;
+};
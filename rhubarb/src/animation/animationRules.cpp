@@ -89,7 +89,6 @@ Timeline<ShapeSet> getShapeSets(Phone phone, centiseconds duration, centiseconds
 	// Returns a timeline with two shape sets, timed as a plosive
 	const auto plosive = [duration, previousDuration](ShapeSet first, ShapeSet second) {
 		const centiseconds minOcclusionDuration = 4_cs;
-		const centiseconds maxOcclusionDuration = 12_cs;
 		const centiseconds occlusionDuration =
 			clamp(previousDuration / 2, minOcclusionDuration, maxOcclusionDuration);
 		return Timeline<ShapeSet> {
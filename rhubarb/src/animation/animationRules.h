@@ -29,6 +29,9 @@ enum class TweenTiming {
 // Returns the tween shape and timing to use to transition between the specified two mouth shapes.
 boost::optional<std::pair<Shape, TweenTiming>> getTween(Shape first, Shape second);
 
+// The maximum time by which the closed shape of a plosive precedes the plosive itself
+constexpr centiseconds maxOcclusionDuration = 12_cs;
+
 // Returns the shape set(s) to use for a given phone.
 // The resulting timeline will always cover the entire duration of the phone (starting at 0 cs).
 // It may extend into the negative time range if animation is required prior to the sound being
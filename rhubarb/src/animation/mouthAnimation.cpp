@@ -7,11 +7,14 @@
 #include "timingOptimization.h"
 #include "targetShapeSet.h"
 #include "staticSegments.h"
+#include "tools/profiling.h"
 
 JoiningContinuousTimeline<Shape> animate(
 	const BoundedTimeline<Phone>& phones,
 	const ShapeSet& targetShapeSet
 ) {
+	profiling::ScopedTimer timer("animation");
+
 	// Create timeline of shape rules
 	ContinuousTimeline<ShapeRule> shapeRules = getShapeRules(phones);
 
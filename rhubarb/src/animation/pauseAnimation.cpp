@@ -1,5 +1,6 @@
 #include "pauseAnimation.h"
 #include "animationRules.h"
+#include "tools/profiling.h"
 
 Shape getPauseShape(Shape previous, Shape next, centiseconds duration) {
 	// For very short pauses: Just hold the previous shape
@@ -8,7 +9,7 @@ Shape getPauseShape(Shape previous, Shape next, centiseconds duration) {
 	}
 
 	// For short pauses: Relax the mouth
-	if (duration <= 35_cs) {
+	if (duration <= maxShortPauseDuration) {
 		// It looks odd if the pause shape is identical to the next shape.
 		// Make sure we find a relaxed shape that's different from the next one.
 		for (Shape currentRelaxedShape = previous;;) {
@@ -29,6 +30,8 @@ Shape getPauseShape(Shape previous, Shape next, centiseconds duration) {
 }
 
 JoiningContinuousTimeline<Shape> animatePauses(const JoiningContinuousTimeline<Shape>& animation) {
+	profiling::ScopedTimer timer("pause animation");
+
 	JoiningContinuousTimeline<Shape> result(animation);
 	
 	for_each_adjacent(
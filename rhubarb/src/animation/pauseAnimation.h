@@ -3,5 +3,9 @@
 #include "core/Shape.h"
 #include "time/ContinuousTimeline.h"
 
+// Pauses up to this long are animated depending on the surrounding shapes; longer pauses close
+// the mouth
+constexpr centiseconds maxShortPauseDuration = 35_cs;
+
 // Takes an existing animation and modifies the pauses (X shapes) to look better.
 JoiningContinuousTimeline<Shape> animatePauses(const JoiningContinuousTimeline<Shape>& animation);
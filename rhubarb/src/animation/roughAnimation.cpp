@@ -1,5 +1,6 @@
 #include "roughAnimation.h"
 #include <boost/optional.hpp>
+#include "tools/profiling.h"
 
 // Create timeline of shapes using a bidirectional algorithm.
 // Here's a rough sketch:
@@ -13,6 +14,8 @@
 //   So whenever we come across a one-shape vowel, we backtrack a little, spreading that shape to
 //   the left.
 JoiningContinuousTimeline<Shape> animateRough(const ContinuousTimeline<ShapeRule>& shapeRules) {
+	profiling::ScopedTimer timer("rough animation");
+
 	JoiningContinuousTimeline<Shape> animation(shapeRules.getRange(), Shape::X);
 
 	Shape referenceShape = Shape::X;
@@ -36,7 +39,6 @@ JoiningContinuousTimeline<Shape> animateRough(const ContinuousTimeline<ShapeRule
 				// Make sure we haven't animated too far back
 				centiseconds anticipatingShapeStart = reverseIt->getStart();
 				if (anticipatingShapeStart == lastAnticipatedShapeStart) break;
-				const centiseconds maxAnticipationDuration = 20_cs;
 				const centiseconds anticipationDuration =
 					anticipatedShapeStart - anticipatingShapeStart;
 				if (anticipationDuration > maxAnticipationDuration) break;
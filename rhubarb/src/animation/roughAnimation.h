@@ -2,6 +2,9 @@
 
 #include "ShapeRule.h"
 
+// The maximum time by which the shape of a vowel is anticipated before the vowel itself
+constexpr centiseconds maxAnticipationDuration = 20_cs;
+
 // Does a rough animation (no tweening, special pause animation, etc.) using a bidirectional
 // algorithm.
 JoiningContinuousTimeline<Shape> animateRough(const ContinuousTimeline<ShapeRule>& shapeRules);
@@ -2,6 +2,7 @@
 #include <vector>
 #include <numeric>
 #include "tools/nextCombination.h"
+#include "tools/profiling.h"
 
 using std::vector;
 
@@ -34,16 +35,14 @@ vector<TimeRange> getStaticSegments(
 	const ContinuousTimeline<ShapeRule>& shapeRules,
 	const JoiningContinuousTimeline<Shape>& animation
 ) {
-	// A static segment must contain a certain number of syllables to look distractingly static
+	// A static segment must contain a certain number of syllables to look distractingly static.
+	// It must also have a minimum duration.
 	const int minSyllableCount = 3;
-	// It must also have a minimum duration. The same number of syllables in fast speech usually
-	// looks good.
-	const centiseconds minDuration = 75_cs;
 
 	vector<TimeRange> result;
 	for (const auto& timedShape : animation) {
 		const TimeRange timeRange = timedShape.getTimeRange();
-		const bool isStatic = timeRange.getDuration() >= minDuration
+		const bool isStatic = timeRange.getDuration() >= minStaticSegmentDuration
 			&& getSyllableCount(shapeRules, timeRange) >= minSyllableCount;
 		if (isStatic) {
 			result.push_back(timeRange);
@@ -212,6 +211,8 @@ JoiningContinuousTimeline<Shape> avoidStaticSegments(
 	const ContinuousTimeline<ShapeRule>& shapeRules,
 	const AnimationFunction& animate
 ) {
+	profiling::ScopedTimer timer("static segments");
+
 	const auto animation = animate(shapeRules);
 	const vector<TimeRange> staticSegments = getStaticSegments(shapeRules, animation);
 	if (staticSegments.empty()) {
@@ -5,6 +5,10 @@
 #include "ShapeRule.h"
 #include <functional>
 
+// The minimum duration of a static segment that is broken up. The same number of syllables in fast
+// speech usually looks good.
+constexpr centiseconds minStaticSegmentDuration = 75_cs;
+
 using AnimationFunction = std::function<JoiningContinuousTimeline<Shape>(const ContinuousTimeline<ShapeRule>&)>;
 
 // Calls the specified animation function with the specified shape rules.
@@ -1,4 +1,5 @@
 #include "targetShapeSet.h"
+#include "tools/profiling.h"
 
 Shape convertToTargetShapeSet(Shape shape, const ShapeSet& targetShapeSet) {
 	if (targetShapeSet.find(shape) != targetShapeSet.end()) {
@@ -24,6 +25,8 @@ ContinuousTimeline<ShapeRule> convertToTargetShapeSet(
 	const ContinuousTimeline<ShapeRule>& shapeRules,
 	const ShapeSet& targetShapeSet
 ) {
+	profiling::ScopedTimer timer("target shape set");
+
 	ContinuousTimeline<ShapeRule> result(shapeRules);
 	for (const auto& timedShapeRule : shapeRules) {
 		ShapeRule rule = timedShapeRule.getValue();
@@ -37,6 +40,8 @@ JoiningContinuousTimeline<Shape> convertToTargetShapeSet(
 	const JoiningContinuousTimeline<Shape>& animation,
 	const ShapeSet& targetShapeSet
 ) {
+	profiling::ScopedTimer timer("target shape set");
+
 	JoiningContinuousTimeline<Shape> result(animation);
 	for (const auto& timedShape : animation) {
 		result.set(
@@ -4,6 +4,7 @@
 #include <map>
 #include <algorithm>
 #include "ShapeRule.h"
+#include "tools/profiling.h"
 
 using std::string;
 using std::map;
@@ -61,10 +62,6 @@ TimeRange getNextMinimalCandidateRange(const JoiningContinuousTimeline<Shape>& s
 		throw std::invalid_argument("Cannot determine candidate range for empty source timeline.");
 	}
 
-	// Too short, and and we get flickering. Too long, and too many shapes are lost.
-	// Good values turn out to be 5 to 7 cs, with 7 cs sometimes looking just marginally better.
-	const centiseconds minShapeDuration = 7_cs;
-
 	// If the remaining time can hold more than one shape, but not two: split it evenly
 	const centiseconds remainingTargetDuration = writePosition - targetRange.getStart();
 	const bool canFitOneOrLess = remainingTargetDuration <= minShapeDuration;
@@ -177,6 +174,8 @@ enum class MouthState {
 };
 
 JoiningContinuousTimeline<Shape> optimizeTiming(const JoiningContinuousTimeline<Shape>& animation) {
+	profiling::ScopedTimer timer("timing optimization");
+
 	// Identify segments with idle, closed, and open mouth shapes
 	JoiningContinuousTimeline<MouthState> segments(animation.getRange(), MouthState::Idle);
 	for (const auto& timedShape : animation) {
@@ -192,8 +191,6 @@ JoiningContinuousTimeline<Shape> optimizeTiming(const JoiningContinuousTimeline<
 
 	// The minimum duration a segment of open or closed mouth shapes must have to visually register
 	const centiseconds minSegmentDuration = 8_cs;
-	// The maximum amount by which the start of a shape can be brought forward
-	const centiseconds maxExtensionDuration = 6_cs;
 
 	// Make sure all open and closed segments are long enough to register visually.
 	JoiningContinuousTimeline<Shape> result(animation.getRange(), Shape::X);
@@ -3,6 +3,14 @@
 #include "core/Shape.h"
 #include "time/ContinuousTimeline.h"
 
+// The minimum duration of a retimed shape.
+// Too short, and and we get flickering. Too long, and too many shapes are lost.
+// Good values turn out to be 5 to 7 cs, with 7 cs sometimes looking just marginally better.
+constexpr centiseconds minShapeDuration = 7_cs;
+
+// The maximum amount by which the start of a short segment of shapes is brought forward
+constexpr centiseconds maxExtensionDuration = 6_cs;
+
 // Changes the timing of an existing animation to reduce jitter and to make sure all shapes register
 // visually.
 // In some cases, shapes may be omitted.
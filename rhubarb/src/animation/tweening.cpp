@@ -1,9 +1,11 @@
 #include "tweening.h"
 #include "animationRules.h"
+#include "tools/profiling.h"
 
 JoiningContinuousTimeline<Shape> insertTweens(const JoiningContinuousTimeline<Shape>& animation) {
+	profiling::ScopedTimer timer("tweening");
+
 	const centiseconds minTweenDuration = 4_cs;
-	const centiseconds maxTweenDuration = 8_cs;
 
 	JoiningContinuousTimeline<Shape> result(animation);
 
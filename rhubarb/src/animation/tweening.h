@@ -3,5 +3,8 @@
 #include "core/Shape.h"
 #include "time/ContinuousTimeline.h"
 
+// The maximum duration of an inbetween shape
+constexpr centiseconds maxTweenDuration = 8_cs;
+
 // Takes an existing animation and inserts inbetween shapes for smoother results.
 JoiningContinuousTimeline<Shape> insertTweens(const JoiningContinuousTimeline<Shape>& animation);
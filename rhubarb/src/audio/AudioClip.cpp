@@ -47,6 +47,24 @@ SampleReader AudioClip::createSampleReader() const {
 	return SafeSampleReader(createUnsafeSampleReader(), size());
 }
 
+void AudioClip::readBlock(size_type start, gsl::span<value_type> out) const {
+	if (start < 0) {
+		throw invalid_argument(fmt::format("Cannot read from sample index {}. Index < 0.", start));
+	}
+	const size_type end = start + static_cast<size_type>(out.size());
+	if (end > size()) {
+		throw invalid_argument(fmt::format(
+			"Cannot read samples {} to {}. Clip size is {}.",
+			start,
+			end - 1,
+			size()
+		));
+	}
+	if (out.size() == 0) return;
+
+	readUnsafeBlock(start, out);
+}
+
 AudioClip::iterator AudioClip::begin() const {
 	return SampleIterator(*this, 0);
 }
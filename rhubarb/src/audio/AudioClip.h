@@ -3,6 +3,7 @@
 #include <memory>
 #include "time/TimeRange.h"
 #include <functional>
+#include <span.h>
 #include "tools/Lazy.h"
 
 class AudioClip;
@@ -22,10 +23,14 @@ public:
 	virtual size_type size() const = 0;
 	TimeRange getTruncatedRange() const;
 	SampleReader createSampleReader() const;
+	// Reads `out.size()` consecutive samples, starting at sample index `start`.
+	// Prefer this over sample readers whenever larger amounts of audio are processed.
+	void readBlock(size_type start, gsl::span<value_type> out) const;
 	iterator begin() const;
 	iterator end() const;
 private:
 	virtual SampleReader createUnsafeSampleReader() const = 0;
+	virtual void readUnsafeBlock(size_type start, gsl::span<value_type> out) const = 0;
 };
 
 using AudioEffect = std::function<std::unique_ptr<AudioClip>(std::unique_ptr<AudioClip>)>;
@@ -23,6 +23,10 @@ SampleReader AudioSegment::createUnsafeSampleReader() const {
 	};
 }
 
+void AudioSegment::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	inputClip->readBlock(start + sampleOffset, out);
+}
+
 AudioEffect segment(const TimeRange& range) {
 	return [range](unique_ptr<AudioClip> inputClip) {
 		return make_unique<AudioSegment>(std::move(inputClip), range);
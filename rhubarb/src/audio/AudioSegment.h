@@ -11,6 +11,7 @@ public:
 
 private:
 	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
 
 	std::shared_ptr<AudioClip> inputClip;
 	size_type sampleOffset, sampleCount;
@@ -1,5 +1,6 @@
 #include "DcOffset.h"
 #include <cmath>
+#include <vector>
 
 using std::unique_ptr;
 using std::make_unique;
@@ -25,6 +26,13 @@ SampleReader DcOffset::createUnsafeSampleReader() const {
 	};
 }
 
+void DcOffset::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	inputClip->readBlock(start, out);
+	for (value_type& sample : out) {
+		sample = sample * factor + offset;
+	}
+}
+
 float getDcOffset(const AudioClip& audioClip) {
 	int flatMeanSampleCount, fadingMeanSampleCount;
 	const int sampleRate = audioClip.getSampleRate();
@@ -38,15 +46,16 @@ float getDcOffset(const AudioClip& audioClip) {
 		fadingMeanSampleCount = 0;
 	}
 
-	const auto read = audioClip.createSampleReader();
+	std::vector<float> samples(flatMeanSampleCount + fadingMeanSampleCount);
+	audioClip.readBlock(0, samples);
 	double sum = 0;
 	for (int i = 0; i < flatMeanSampleCount; ++i) {
-		sum += read(i);
+		sum += samples[i];
 	}
 	for (int i = 0; i < fadingMeanSampleCount; ++i) {
 		const double weight =
 			static_cast<double>(fadingMeanSampleCount - i) / fadingMeanSampleCount;
-		sum += read(flatMeanSampleCount + i) * weight;
+		sum += samples[flatMeanSampleCount + i] * weight;
 	}
 
 	const double totalWeight = flatMeanSampleCount + (fadingMeanSampleCount + 1) / 2.0;
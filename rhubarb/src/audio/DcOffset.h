@@ -12,6 +12,7 @@ public:
 	size_type size() const override;
 private:
 	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
 
 	std::shared_ptr<AudioClip> inputClip;
 	float offset;
@@ -0,0 +1,86 @@
+#include "MemoryAudioClip.h"
+#include "processing.h"
+#include <format.h>
+#include <stdexcept>
+
+using std::unique_ptr;
+using std::make_unique;
+using std::make_shared;
+using std::shared_ptr;
+using std::vector;
+using std::invalid_argument;
+
+MemoryAudioClip::MemoryAudioClip(shared_ptr<const vector<int16_t>> buffer, int sampleRate) :
+	MemoryAudioClip(buffer, sampleRate, 0, static_cast<size_type>(buffer->size()))
+{}
+
+MemoryAudioClip::MemoryAudioClip(
+	shared_ptr<const vector<int16_t>> buffer,
+	int sampleRate,
+	size_type sampleOffset,
+	size_type sampleCount
+) :
+	buffer(std::move(buffer)),
+	sampleRate(sampleRate),
+	sampleOffset(sampleOffset),
+	sampleCount(sampleCount)
+{}
+
+unique_ptr<AudioClip> MemoryAudioClip::clone() const {
+	return make_unique<MemoryAudioClip>(*this);
+}
+
+MemoryAudioClip MemoryAudioClip::getSegment(const TimeRange& range) const {
+	// Check the range in the time domain first, so that the conversion to samples can't overflow
+	const centiseconds duration((sampleCount * 100 + sampleRate - 1) / sampleRate);
+	if (range.getStart() < 0_cs || range.getEnd() > duration) {
+		throw invalid_argument(fmt::format(
+			"Cannot create segment from {} to {}. Clip duration is {}.",
+			range.getStart(),
+			range.getEnd(),
+			duration
+		));
+	}
+
+	const size_type segmentOffset = static_cast<int64_t>(range.getStart().count()) * sampleRate / 100;
+	const size_type segmentCount = static_cast<int64_t>(range.getDuration().count()) * sampleRate / 100;
+	if (segmentCount < 0) {
+		throw invalid_argument(fmt::format("Cannot create segment of {} samples. Count < 0.", segmentCount));
+	}
+	if (segmentOffset + segmentCount > sampleCount) {
+		throw invalid_argument(fmt::format(
+			"Cannot create segment of samples {} to {}. Clip size is {}.",
+			segmentOffset,
+			segmentOffset + segmentCount - 1,
+			sampleCount
+		));
+	}
+
+	return MemoryAudioClip(buffer, sampleRate, sampleOffset + segmentOffset, segmentCount);
+}
+
+SampleReader MemoryAudioClip::createUnsafeSampleReader() const {
+	return [samples = getSamples(), buffer = buffer](size_type index) {
+		return int16ToFloatSample(samples[index]);
+	};
+}
+
+void MemoryAudioClip::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	const int16_t* samples = buffer->data() + sampleOffset + start;
+	for (size_type i = 0; i < static_cast<size_type>(out.size()); ++i) {
+		out[i] = int16ToFloatSample(samples[i]);
+	}
+}
+
+MemoryAudioClip bufferAudioClip(const AudioClip& audioClip, ProgressSink& progressSink) {
+	const auto buffer = make_shared<vector<int16_t>>();
+	buffer->reserve(static_cast<size_t>(audioClip.size()));
+	process16bitAudioClip(
+		audioClip,
+		[&](const vector<int16_t>& samples) {
+			buffer->insert(buffer->end(), samples.begin(), samples.end());
+		},
+		progressSink
+	);
+	return MemoryAudioClip(buffer, audioClip.getSampleRate());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "AudioClip.h"
+#include "tools/progress.h"
+
+// Audio clip backed by 16-bit samples in memory.
+// Copies and segments are views that share the same sample buffer.
+class MemoryAudioClip : public AudioClip {
+public:
+	MemoryAudioClip(std::shared_ptr<const std::vector<int16_t>> buffer, int sampleRate);
+	std::unique_ptr<AudioClip> clone() const override;
+	int getSampleRate() const override;
+	size_type size() const override;
+
+	// Returns the samples of this clip without copying them
+	gsl::span<const int16_t> getSamples() const;
+
+	// Returns a view of the specified part of this clip
+	MemoryAudioClip getSegment(const TimeRange& range) const;
+
+private:
+	MemoryAudioClip(
+		std::shared_ptr<const std::vector<int16_t>> buffer,
+		int sampleRate,
+		size_type sampleOffset,
+		size_type sampleCount
+	);
+	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
+
+	std::shared_ptr<const std::vector<int16_t>> buffer;
+	int sampleRate;
+	size_type sampleOffset, sampleCount;
+};
+
+inline int MemoryAudioClip::getSampleRate() const {
+	return sampleRate;
+}
+
+inline AudioClip::size_type MemoryAudioClip::size() const {
+	return sampleCount;
+}
+
+inline gsl::span<const int16_t> MemoryAudioClip::getSamples() const {
+	return gsl::span<const int16_t>(buffer->data() + sampleOffset, sampleCount);
+}
+
+// Decodes the entire audio clip to 16-bit samples in memory
+MemoryAudioClip bufferAudioClip(const AudioClip& audioClip, ProgressSink& progressSink);
@@ -5,6 +5,7 @@
 #include "tools/tools.h"
 #include <format.h>
 #include "tools/fileTools.h"
+#include <mutex>
 
 using std::filesystem::path;
 using std::vector;
@@ -118,8 +119,15 @@ OggVorbisFile::OggVorbisFile(const path& filePath) :
 	throwOnError(ov_open_callbacks(&stream, &oggVorbisHandle, nullptr, 0, callbacks));
 }
 
+struct OggVorbisFileReader::BlockDecoder {
+	std::mutex mutex;
+	std::unique_ptr<OggVorbisFile> file;
+	size_type position = 0;
+};
+
 OggVorbisFileReader::OggVorbisFileReader(const path& filePath) :
-	filePath(filePath)
+	filePath(filePath),
+	blockDecoder(make_shared<BlockDecoder>())
 {
 	OggVorbisFile file(filePath);
 	
@@ -131,7 +139,9 @@ OggVorbisFileReader::OggVorbisFileReader(const path& filePath) :
 }
 
 std::unique_ptr<AudioClip> OggVorbisFileReader::clone() const {
-	return std::make_unique<OggVorbisFileReader>(*this);
+	auto result = std::make_unique<OggVorbisFileReader>(*this);
+	result->blockDecoder = make_shared<BlockDecoder>();
+	return result;
 }
 
 SampleReader OggVorbisFileReader::createUnsafeSampleReader() const {
@@ -164,3 +174,45 @@ SampleReader OggVorbisFileReader::createUnsafeSampleReader() const {
 		return sum / channelCount;
 	};
 }
+
+void OggVorbisFileReader::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	std::lock_guard<std::mutex> lock(blockDecoder->mutex);
+	try {
+		if (!blockDecoder->file) {
+			blockDecoder->file = std::make_unique<OggVorbisFile>(filePath);
+			blockDecoder->position = 0;
+		}
+		OggVorbisFile& file = *blockDecoder->file;
+		if (blockDecoder->position != start) {
+			throwOnError(ov_pcm_seek(file.get(), start));
+			blockDecoder->position = start;
+		}
+
+		size_type outIndex = 0;
+		const size_type outSize = out.size();
+		while (outIndex < outSize) {
+			// Read a block of samples
+			constexpr int maxSize = 1024;
+			value_type** buffer = nullptr;
+			const int bufferSize = static_cast<int>(std::min<size_type>(maxSize, outSize - outIndex));
+			const size_type readCount = throwOnError(ov_read_float(file.get(), &buffer, bufferSize, nullptr));
+			if (readCount == 0) {
+				throw std::runtime_error("Unexpected end of file.");
+			}
+
+			// Downmix channels
+			for (size_type bufferIndex = 0; bufferIndex < readCount; ++bufferIndex) {
+				value_type sum = 0.0f;
+				for (int channel = 0; channel < channelCount; ++channel) {
+					sum += buffer[channel][bufferIndex];
+				}
+				out[outIndex++] = sum / channelCount;
+			}
+			blockDecoder->position += readCount;
+		}
+	} catch (...) {
+		// The decoder position is unknown, so start over next time
+		blockDecoder->file.reset();
+		throw;
+	}
+}
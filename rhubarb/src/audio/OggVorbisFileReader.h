@@ -2,6 +2,7 @@
 
 #include "AudioClip.h"
 #include <filesystem>
+#include <memory>
 
 class OggVorbisFileReader : public AudioClip {
 public:
@@ -12,9 +13,15 @@ public:
 
 private:
 	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
+
+	// Decoder kept open between block reads, so that sequential reads continue where the last one
+	// ended. Not shared between clones.
+	struct BlockDecoder;
 
 	std::filesystem::path filePath;
 	int sampleRate;
 	int channelCount;
 	size_type sampleCount;
+	std::shared_ptr<BlockDecoder> blockDecoder;
 };
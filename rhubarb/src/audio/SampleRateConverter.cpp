@@ -2,69 +2,269 @@
 #include "SampleRateConverter.h"
 #include <stdexcept>
 #include <format.h>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <limits>
+#include <algorithm>
 
 using std::invalid_argument;
 using std::unique_ptr;
 using std::make_unique;
+using std::shared_ptr;
+using std::make_shared;
+using std::vector;
+
+// Above this number of phases, fractional positions are rounded to the nearest of
+// maxPhaseCount phases. This keeps the tables small for unusual sample rates.
+constexpr int maxPhaseCount = 1024;
+
+// Number of sinc zero crossings on either side of the filter center.
+// More zero crossings make for a steeper transition band, but cost more taps.
+constexpr int zeroCrossingCount = 12;
+
+// Fraction of the lower Nyquist frequency to pass unattenuated
+constexpr double passbandFraction = 0.9;
+
+double sinc(double x) {
+	constexpr double pi = 3.14159265358979323846;
+	return x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+}
+
+// Blackman window for x in -1..1
+double blackmanWindow(double x) {
+	constexpr double pi = 3.14159265358979323846;
+	if (std::abs(x) >= 1) return 0.0;
+	return 0.42 + 0.5 * std::cos(pi * x) + 0.08 * std::cos(2 * pi * x);
+}
+
+PolyphaseFilter::PolyphaseFilter(int inputSampleRate, int outputSampleRate) {
+	if (inputSampleRate <= 0 || outputSampleRate <= 0) {
+		throw invalid_argument("Sample rate must be positive.");
+	}
+
+	const int64_t divisor = std::gcd(inputSampleRate, outputSampleRate);
+	upFactor = outputSampleRate / divisor;
+	downFactor = inputSampleRate / divisor;
+	phaseCount = static_cast<int>(std::min<int64_t>(upFactor, maxPhaseCount));
+
+	if (upFactor == 1 && downFactor == 1) {
+		// Same sample rate: use a unit impulse, so that the samples pass through unchanged
+		tapCount = 8;
+		coefficients.assign(static_cast<size_t>(tapCount), 0.0f);
+		coefficients[tapCount / 2 - 1] = 1.0f;
+		return;
+	}
+
+	// Cutoff frequency in cycles per input sample
+	const double cutoff =
+		0.5 * std::min(1.0, static_cast<double>(outputSampleRate) / inputSampleRate) * passbandFraction;
+	const double halfWidth = zeroCrossingCount / (2 * cutoff);
+	// Use a multiple of the vector width so the filter loop needs no remainder handling
+	const int halfTapCount = (static_cast<int>(std::ceil(halfWidth)) + 3) / 4 * 4;
+	tapCount = 2 * halfTapCount;
+
+	coefficients.resize(static_cast<size_t>(phaseCount) * tapCount);
+	for (int phase = 0; phase < phaseCount; ++phase) {
+		float* phaseCoefficients = coefficients.data() + phase * tapCount;
+		double sum = 0;
+		for (int tap = 0; tap < tapCount; ++tap) {
+			const double distance = static_cast<double>(phase) / phaseCount + (tapCount / 2 - 1 - tap);
+			const double value =
+				2 * cutoff * sinc(2 * cutoff * distance) * blackmanWindow(distance / halfWidth);
+			phaseCoefficients[tap] = static_cast<float>(value);
+			sum += value;
+		}
+
+		// Normalize for unit gain at DC
+		for (int tap = 0; tap < tapCount; ++tap) {
+			phaseCoefficients[tap] = static_cast<float>(phaseCoefficients[tap] / sum);
+		}
+	}
+}
+
+shared_ptr<const PolyphaseFilter> getPolyphaseFilter(int inputSampleRate, int outputSampleRate) {
+	static std::mutex mutex;
+	static std::map<std::pair<int, int>, shared_ptr<const PolyphaseFilter>> filters;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& filter = filters[{ inputSampleRate, outputSampleRate }];
+	if (!filter) {
+		filter = make_shared<PolyphaseFilter>(inputSampleRate, outputSampleRate);
+	}
+	return filter;
+}
 
 SampleRateConverter::SampleRateConverter(unique_ptr<AudioClip> inputClip, int outputSampleRate) :
 	inputClip(std::move(inputClip)),
-	downscalingFactor(static_cast<double>(this->inputClip->getSampleRate()) / outputSampleRate),
-	outputSampleRate(outputSampleRate),
-	outputSampleCount(std::lround(this->inputClip->size() / downscalingFactor))
+	outputSampleRate(outputSampleRate)
 {
 	if (outputSampleRate <= 0) {
 		throw invalid_argument("Sample rate must be positive.");
 	}
-	if (this->inputClip->getSampleRate() < outputSampleRate) {
-		throw invalid_argument(fmt::format(
-			"Upsampling not supported. Input sample rate must not be below {}Hz.",
-			outputSampleRate
-		));
-	}
+
+	const int inputSampleRate = this->inputClip->getSampleRate();
+	filter = getPolyphaseFilter(inputSampleRate, outputSampleRate);
+	outputSampleCount = std::lround(
+		this->inputClip->size() / (static_cast<double>(inputSampleRate) / outputSampleRate)
+	);
 }
 
 unique_ptr<AudioClip> SampleRateConverter::clone() const {
 	return make_unique<SampleRateConverter>(*this);
 }
 
-float mean(double inputStart, double inputEnd, const SampleReader& read) {
-	// Calculate weighted sum...
-	double sum = 0;
-
-	// ... first sample (weight <= 1)
-	const int64_t startIndex = static_cast<int64_t>(inputStart);
-	sum += read(startIndex) * ((startIndex + 1) - inputStart);
+// Determines the input position of an output sample as base index plus phase
+inline void getInputPosition(
+	const PolyphaseFilter& filter,
+	int64_t outputIndex,
+	int64_t& baseIndex,
+	int& phase
+) {
+	const int64_t numerator = outputIndex * filter.downFactor;
+	baseIndex = numerator / filter.upFactor;
+	const int64_t remainder = numerator % filter.upFactor;
+	if (filter.phaseCount == filter.upFactor) {
+		phase = static_cast<int>(remainder);
+	} else {
+		phase = static_cast<int>((remainder * filter.phaseCount + filter.upFactor / 2) / filter.upFactor);
+		if (phase == filter.phaseCount) {
+			++baseIndex;
+			phase = 0;
+		}
+	}
+}
 
-	// ... middle samples (weight 1 each)
-	const int64_t endIndex = static_cast<int64_t>(inputEnd);
-	for (int64_t index = startIndex + 1; index < endIndex; ++index) {
-		sum += read(index);
+// Computes a single output sample from the input samples covered by the specified phase
+inline float applyFilterPhase(const float* samples, const float* coefficients, int tapCount) {
+	// Accumulate in independent lanes so that the compiler can vectorize the loop
+	constexpr int laneCount = 8;
+	float sums[laneCount] = {};
+	for (int tap = 0; tap < tapCount; tap += laneCount) {
+		for (int lane = 0; lane < laneCount; ++lane) {
+			sums[lane] += samples[tap + lane] * coefficients[tap + lane];
+		}
 	}
+	return ((sums[0] + sums[4]) + (sums[1] + sums[5]))
+		+ ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+}
+
+void resampleBlock(
+	const AudioClip& inputClip,
+	const PolyphaseFilter& filter,
+	AudioClip::size_type start,
+	gsl::span<AudioClip::value_type> out
+) {
+	const AudioClip::size_type end = start + static_cast<AudioClip::size_type>(out.size());
+	const int halfTapCount = filter.tapCount / 2;
 
-	// ... last sample (weight < 1)
-	if (endIndex < inputEnd) {
-		sum += read(endIndex) * (inputEnd - endIndex);
+	// Determine the input range contributing to the requested output samples
+	int64_t firstBaseIndex, lastBaseIndex;
+	int phase;
+	getInputPosition(filter, start, firstBaseIndex, phase);
+	getInputPosition(filter, end - 1, lastBaseIndex, phase);
+	const int64_t inputStart = firstBaseIndex - halfTapCount + 1;
+	const int64_t inputEnd = lastBaseIndex + halfTapCount + 1;
+
+	// Read input in one go, padding with silence beyond the clip boundaries
+	vector<float> input(static_cast<size_t>(inputEnd - inputStart), 0.0f);
+	const int64_t readStart = std::max<int64_t>(inputStart, 0);
+	const int64_t readEnd = std::min<int64_t>(inputEnd, inputClip.size());
+	if (readEnd > readStart) {
+		inputClip.readBlock(
+			readStart,
+			gsl::span<float>(input.data() + (readStart - inputStart), readEnd - readStart)
+		);
 	}
 
-	return static_cast<float>(sum / (inputEnd - inputStart));
+	// Apply filter
+	for (AudioClip::size_type index = start; index < end; ++index) {
+		int64_t baseIndex;
+		getInputPosition(filter, index, baseIndex, phase);
+		const float* samples = input.data() + (baseIndex - halfTapCount + 1 - inputStart);
+		out[index - start] = applyFilterPhase(samples, filter.getPhase(phase), filter.tapCount);
+	}
 }
 
 SampleReader SampleRateConverter::createUnsafeSampleReader() const {
 	return [
-		read = inputClip->createSampleReader(),
-		downscalingFactor = downscalingFactor,
-		size = inputClip->size()
-		](size_type index) {
-		const double inputStart = index * downscalingFactor;
-		const double inputEnd =
-			std::min((index + 1) * downscalingFactor, static_cast<double>(size));
-		return mean(inputStart, inputEnd, read);
+		inputClip = inputClip,
+		filter = filter,
+		size = outputSampleCount,
+		buffer = vector<value_type>(),
+		bufferStart = size_type(0)
+	](size_type index) mutable {
+		if (index < bufferStart || index >= bufferStart + static_cast<size_type>(buffer.size())) {
+			// Resample a block of samples so that sequential reads share the input read and setup
+			constexpr size_type maxSize = 1024;
+			bufferStart = index;
+			buffer.resize(static_cast<size_t>(std::min(maxSize, size - index)));
+			resampleBlock(*inputClip, *filter, bufferStart, buffer);
+		}
+		return buffer[static_cast<size_t>(index - bufferStart)];
 	};
 }
 
+void SampleRateConverter::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	resampleBlock(*inputClip, *filter, start, out);
+}
+
 AudioEffect resample(int sampleRate) {
-	return [sampleRate](unique_ptr<AudioClip> inputClip) {
+	return [sampleRate](unique_ptr<AudioClip> inputClip) -> unique_ptr<AudioClip> {
+		if (inputClip->getSampleRate() == sampleRate) return inputClip;
 		return make_unique<SampleRateConverter>(std::move(inputClip), sampleRate);
 	};
 }
+
+StreamingSampleRateConverter::StreamingSampleRateConverter(
+	int inputSampleRate,
+	int outputSampleRate
+) :
+	filter(getPolyphaseFilter(inputSampleRate, outputSampleRate)),
+	inputSampleRate(inputSampleRate),
+	outputSampleRate(outputSampleRate),
+	// Everything before the start of the input is silence
+	history(static_cast<size_t>(filter->tapCount / 2), 0.0f),
+	historyStart(-(filter->tapCount / 2))
+{}
+
+void StreamingSampleRateConverter::write(gsl::span<const float> input, vector<float>& output) {
+	history.insert(history.end(), input.begin(), input.end());
+	inputSampleCount += input.size();
+	resampleAvailable(output, std::numeric_limits<int64_t>::max());
+}
+
+void StreamingSampleRateConverter::flush(vector<float>& output) {
+	const int64_t outputEnd = std::lround(
+		inputSampleCount / (static_cast<double>(inputSampleRate) / outputSampleRate)
+	);
+
+	// Everything after the end of the input is silence
+	history.insert(history.end(), static_cast<size_t>(filter->tapCount), 0.0f);
+	resampleAvailable(output, outputEnd);
+}
+
+void StreamingSampleRateConverter::resampleAvailable(vector<float>& output, int64_t outputEnd) {
+	const int halfTapCount = filter->tapCount / 2;
+	const int64_t historyEnd = historyStart + static_cast<int64_t>(history.size());
+	int64_t baseIndex;
+	int phase;
+	for (; outputSampleCount < outputEnd; ++outputSampleCount) {
+		getInputPosition(*filter, outputSampleCount, baseIndex, phase);
+		if (baseIndex + halfTapCount + 1 > historyEnd) break;
+
+		const float* samples = history.data() + (baseIndex - halfTapCount + 1 - historyStart);
+		output.push_back(applyFilterPhase(samples, filter->getPhase(phase), filter->tapCount));
+	}
+
+	// Discard input samples that no further output sample depends on
+	getInputPosition(*filter, outputSampleCount, baseIndex, phase);
+	const int64_t discardCount = std::min<int64_t>(
+		baseIndex - halfTapCount + 1 - historyStart,
+		static_cast<int64_t>(history.size())
+	);
+	if (discardCount > 0) {
+		history.erase(history.begin(), history.begin() + discardCount);
+		historyStart += discardCount;
+	}
+}
@@ -1,8 +1,32 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "AudioClip.h"
 
+// Precomputed windowed-sinc lowpass filter, split into polyphase components.
+// Converts between two sample rates related by the ratio upFactor / downFactor.
+// For equal sample rates, the filter is a unit impulse.
+struct PolyphaseFilter {
+	PolyphaseFilter(int inputSampleRate, int outputSampleRate);
+
+	// Returns the coefficients of the specified phase
+	const float* getPhase(int phase) const {
+		return coefficients.data() + phase * tapCount;
+	}
+
+	int64_t upFactor;
+	int64_t downFactor;
+	int phaseCount;
+	// Number of taps per phase; always a multiple of 8. The filter for phase p is centered
+	// between taps (tapCount / 2 - 1) and (tapCount / 2), at distance p / phaseCount from the former.
+	int tapCount;
+	std::vector<float> coefficients;
+};
+
+// Returns a shared filter for the specified conversion, creating it on first use
+std::shared_ptr<const PolyphaseFilter> getPolyphaseFilter(int inputSampleRate, int outputSampleRate);
+
 class SampleRateConverter : public AudioClip {
 public:
 	SampleRateConverter(std::unique_ptr<AudioClip> inputClip, int outputSampleRate);
@@ -11,15 +35,42 @@ public:
 	size_type size() const override;
 private:
 	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
 
 	std::shared_ptr<AudioClip> inputClip;
-	double downscalingFactor; // input sample rate / output sample rate
+	std::shared_ptr<const PolyphaseFilter> filter;
 	int outputSampleRate;
 	int64_t outputSampleCount;
 };
 
+// Returns the clip itself if it already has the specified sample rate
 AudioEffect resample(int sampleRate);
 
+// Resamples audio that arrives in consecutive blocks.
+// The output is identical to that of SampleRateConverter for the concatenated input.
+class StreamingSampleRateConverter {
+public:
+	StreamingSampleRateConverter(int inputSampleRate, int outputSampleRate);
+
+	// Adds input samples, appending all output samples that can be computed so far
+	void write(gsl::span<const float> input, std::vector<float>& output);
+
+	// Appends the remaining output samples, treating the input as complete
+	void flush(std::vector<float>& output);
+
+private:
+	void resampleAvailable(std::vector<float>& output, int64_t outputEnd);
+
+	std::shared_ptr<const PolyphaseFilter> filter;
+	int inputSampleRate;
+	int outputSampleRate;
+	// Most recent input samples, starting at input index historyStart
+	std::vector<float> history;
+	int64_t historyStart;
+	int64_t inputSampleCount = 0;
+	int64_t outputSampleCount = 0;
+};
+
 inline int SampleRateConverter::getSampleRate() const {
 	return outputSampleRate;
 }
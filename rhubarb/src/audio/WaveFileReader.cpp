@@ -2,8 +2,11 @@
 #include "WaveFileReader.h"
 #include "ioTools.h"
 #include <iostream>
+#include <cstring>
+#include <vector>
 #include "tools/platformTools.h"
 #include "tools/fileTools.h"
+#include "tools/MemoryMappedFile.h"
 
 using std::runtime_error;
 using fmt::format;
@@ -173,80 +176,152 @@ WaveFormatInfo getWaveFormatInfo(const path& filePath) {
 
 WaveFileReader::WaveFileReader(const path& filePath) :
 	filePath(filePath),
-	formatInfo(getWaveFormatInfo(filePath)) {}
+	formatInfo(getWaveFormatInfo(filePath)),
+	file(make_shared<MemoryMappedFile>(filePath)) {}
 
 unique_ptr<AudioClip> WaveFileReader::clone() const {
 	return make_unique<WaveFileReader>(*this);
 }
 
-inline AudioClip::value_type readSample(
-	std::ifstream& file,
-	SampleFormat sampleFormat,
-	int channelCount
-) {
-	float sum = 0;
-	for (int channelIndex = 0; channelIndex < channelCount; channelIndex++) {
-		switch (sampleFormat) {
-			case SampleFormat::UInt8:
-			{
-				const uint8_t raw = read<uint8_t>(file);
-				sum += toNormalizedFloat(raw, 0, UINT8_MAX);
-				break;
+// Reads a little-endian value from the specified memory location
+template<typename Type>
+inline Type readUnaligned(const char* p) {
+	Type result;
+	std::memcpy(&result, p, sizeof(Type));
+	return result;
+}
+
+// Decodes interleaved samples to floats in the range -1..1.
+// The loops are deliberately kept trivial so that the compiler can vectorize them.
+void decodeSamples(const char* bytes, SampleFormat sampleFormat, size_t sampleCount, float* out) {
+	switch (sampleFormat) {
+		case SampleFormat::UInt8:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				out[i] = toNormalizedFloat(static_cast<uint8_t>(bytes[i]), 0, UINT8_MAX);
 			}
-			case SampleFormat::Int16:
-			{
-				const int16_t raw = read<int16_t>(file);
-				sum += toNormalizedFloat(raw, INT16_MIN, INT16_MAX);
-				break;
+			break;
+		case SampleFormat::Int16:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				const int16_t raw = readUnaligned<int16_t>(bytes + 2 * i);
+				out[i] = toNormalizedFloat(raw, INT16_MIN, INT16_MAX);
 			}
-			case SampleFormat::Int24:
-			{
-				int raw = read<int, 24>(file);
-				if (raw & 0x800000) raw |= 0xFF000000; // Fix two's complement
-				sum += toNormalizedFloat(raw, INT24_MIN, INT24_MAX);
-				break;
+			break;
+		case SampleFormat::Int24:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				const char* p = bytes + 3 * i;
+				// Casting the most significant byte to int8_t takes care of two's complement
+				const int raw = static_cast<uint8_t>(p[0])
+					| (static_cast<uint8_t>(p[1]) << 8)
+					| (static_cast<int8_t>(p[2]) * (1 << 16));
+				out[i] = toNormalizedFloat(raw, INT24_MIN, INT24_MAX);
 			}
-			case SampleFormat::Int32:
-			{
-				const int32_t raw = read<int32_t>(file);
-				sum += toNormalizedFloat(raw, INT32_MIN, INT32_MAX);
-				break;
+			break;
+		case SampleFormat::Int32:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				const int32_t raw = readUnaligned<int32_t>(bytes + 4 * i);
+				out[i] = toNormalizedFloat(raw, INT32_MIN, INT32_MAX);
 			}
-			case SampleFormat::Float32:
-			{
-				sum += read<float>(file);
-				break;
+			break;
+		case SampleFormat::Float32:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				out[i] = readUnaligned<float>(bytes + 4 * i);
 			}
-			case SampleFormat::Float64:
-			{
-				sum += static_cast<float>(read<double>(file));
-				break;
+			break;
+		case SampleFormat::Float64:
+			for (size_t i = 0; i < sampleCount; ++i) {
+				out[i] = static_cast<float>(readUnaligned<double>(bytes + 8 * i));
 			}
+			break;
+	}
+}
+
+// Averages interleaved channels. Specialized for common channel counts to allow vectorization.
+template<int channelCount>
+void downmix(const float* samples, size_t frameCount, float* out) {
+	for (size_t i = 0; i < frameCount; ++i) {
+		float sum = 0;
+		for (int channelIndex = 0; channelIndex < channelCount; channelIndex++) {
+			sum += samples[i * channelCount + channelIndex];
 		}
+		out[i] = sum / channelCount;
 	}
+}
 
-	return sum / channelCount;
+void downmix(const float* samples, int channelCount, size_t frameCount, float* out) {
+	switch (channelCount) {
+		case 1: downmix<1>(samples, frameCount, out); break;
+		case 2: downmix<2>(samples, frameCount, out); break;
+		default:
+			for (size_t i = 0; i < frameCount; ++i) {
+				float sum = 0;
+				for (int channelIndex = 0; channelIndex < channelCount; channelIndex++) {
+					sum += samples[i * channelCount + channelIndex];
+				}
+				out[i] = sum / channelCount;
+			}
+	}
+}
+
+// Returns a pointer to the raw data of the specified frames
+const char* getFrames(
+	const MemoryMappedFile& file,
+	const WaveFormatInfo& formatInfo,
+	AudioClip::size_type start,
+	size_t frameCount
+) {
+	const streamoff byteOffset =
+		static_cast<streamoff>(formatInfo.dataOffset) + start * formatInfo.bytesPerFrame;
+	if (byteOffset + static_cast<streamoff>(frameCount * formatInfo.bytesPerFrame) > static_cast<streamoff>(file.size())) {
+		throw runtime_error("Unexpected end of file.");
+	}
+	return file.data() + byteOffset;
+}
+
+void decodeFrames(
+	const MemoryMappedFile& file,
+	const WaveFormatInfo& formatInfo,
+	AudioClip::size_type start,
+	gsl::span<AudioClip::value_type> out
+) {
+	const size_t frameCount = static_cast<size_t>(out.size());
+	const char* frames = getFrames(file, formatInfo, start, frameCount);
+
+	// Decode in chunks that fit into the CPU cache
+	const int channelCount = formatInfo.channelCount;
+	const size_t chunkFrameCount = std::min(frameCount, std::max<size_t>(4096 / channelCount, 1));
+	std::vector<float> samples(chunkFrameCount * channelCount);
+	for (size_t frameIndex = 0; frameIndex < frameCount; frameIndex += chunkFrameCount) {
+		const size_t count = std::min(chunkFrameCount, frameCount - frameIndex);
+		decodeSamples(
+			frames + frameIndex * formatInfo.bytesPerFrame,
+			formatInfo.sampleFormat,
+			count * channelCount,
+			samples.data()
+		);
+		downmix(samples.data(), channelCount, count, out.data() + frameIndex);
+	}
 }
 
 SampleReader WaveFileReader::createUnsafeSampleReader() const {
-	return
-		[
-			formatInfo = formatInfo,
-			file = std::make_shared<std::ifstream>(openFile(filePath)),
-			filePos = std::streampos(0)
-		](size_type index) mutable {
-		const std::streampos newFilePos = formatInfo.dataOffset
-			+ static_cast<streamoff>(index * formatInfo.bytesPerFrame);
-		if (newFilePos != filePos) {
-			file->seekg(newFilePos);
+	return [formatInfo = formatInfo, file = file](size_type index) {
+		// Decode a single frame in place, without the scratch buffer used for blocks
+		const char* frame = getFrames(*file, formatInfo, index, 1);
+		const int channelCount = formatInfo.channelCount;
+		const int bytesPerSample = formatInfo.bytesPerFrame / channelCount;
+		value_type sum = 0;
+		for (int channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+			value_type sample;
+			decodeSamples(frame + channelIndex * bytesPerSample, formatInfo.sampleFormat, 1, &sample);
+			sum += sample;
 		}
-		const value_type result =
-			readSample(*file, formatInfo.sampleFormat, formatInfo.channelCount);
-		filePos = newFilePos + static_cast<streamoff>(formatInfo.bytesPerFrame);
-		return result;
+		return sum / channelCount;
 	};
 }
 
+void WaveFileReader::readUnsafeBlock(size_type start, gsl::span<value_type> out) const {
+	decodeFrames(*file, formatInfo, start, out);
+}
+
 string codecToString(int codec) {
 	switch (codec) {
 		case 0x0001: return "PCM";
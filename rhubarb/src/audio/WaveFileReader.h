@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include "AudioClip.h"
+#include "tools/MemoryMappedFile.h"
 
 enum class SampleFormat {
 	UInt8,
@@ -32,9 +33,12 @@ public:
 
 private:
 	SampleReader createUnsafeSampleReader() const override;
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override;
 
 	std::filesystem::path filePath;
 	WaveFormatInfo formatInfo;
+	// Shared between clones so that all threads read from the same mapping
+	std::shared_ptr<const MemoryMappedFile> file;
 };
 
 inline int WaveFileReader::getSampleRate() const {
@@ -4,12 +4,8 @@
 using std::function;
 using std::vector;
 
-// Converts a float in the range -1..1 to a signed 16-bit int
-inline int16_t floatSampleToInt16(float sample) {
-	sample = std::max(sample, -1.0f);
-	sample = std::min(sample, 1.0f);
-	return static_cast<int16_t>(((sample + 1) / 2) * (INT16_MAX - INT16_MIN) + INT16_MIN);
-}
+// Number of samples to read from an audio clip at once
+constexpr size_t readBlockSize = 1 << 16;
 
 void process16bitAudioClip(
 	const AudioClip& audioClip,
@@ -17,25 +13,38 @@ void process16bitAudioClip(
 	size_t bufferCapacity,
 	ProgressSink& progressSink
 ) {
+	if (bufferCapacity == 0) {
+		throw std::invalid_argument("Buffer capacity must be positive.");
+	}
+
+	// Read several buffers' worth of samples at once
+	const size_t blockCapacity = std::max(bufferCapacity, readBlockSize / bufferCapacity * bufferCapacity);
+	vector<float> block(blockCapacity);
+
 	// Process entire sound stream
 	vector<int16_t> buffer;
 	buffer.reserve(bufferCapacity);
 	size_t sampleCount = 0;
-	auto it = audioClip.begin();
-	const auto end = audioClip.end();
+	const size_t totalSampleCount = static_cast<size_t>(audioClip.size());
 	do {
-		// Read to buffer
-		buffer.clear();
-		for (; buffer.size() < bufferCapacity && it != end; ++it) {
-			// Read sample to buffer
-			buffer.push_back(floatSampleToInt16(*it));
-		}
-
-		// Process buffer
-		processBuffer(buffer);
-
-		sampleCount += buffer.size();
-		progressSink.reportProgress(static_cast<double>(sampleCount) / static_cast<double>(audioClip.size()));
+		// Read block
+		const size_t blockSize = std::min(blockCapacity, totalSampleCount - sampleCount);
+		audioClip.readBlock(sampleCount, gsl::span<float>(block.data(), blockSize));
+
+		size_t blockIndex = 0;
+		do {
+			// Read to buffer
+			buffer.clear();
+			for (; buffer.size() < bufferCapacity && blockIndex < blockSize; ++blockIndex) {
+				buffer.push_back(floatSampleToInt16(block[blockIndex]));
+			}
+
+			// Process buffer
+			processBuffer(buffer);
+
+			sampleCount += buffer.size();
+			progressSink.reportProgress(static_cast<double>(sampleCount) / static_cast<double>(audioClip.size()));
+		} while (!buffer.empty() && blockIndex < blockSize);
 	} while (!buffer.empty());
 }
 
@@ -50,9 +59,11 @@ void process16bitAudioClip(
 
 vector<int16_t> copyTo16bitBuffer(const AudioClip& audioClip) {
 	vector<int16_t> result(static_cast<size_t>(audioClip.size()));
-	int index = 0;
-	for (float sample : audioClip) {
-		result[index++] = floatSampleToInt16(sample);
+	vector<float> block(std::min(readBlockSize, result.size()));
+	for (size_t start = 0; start < result.size(); start += block.size()) {
+		const size_t blockSize = std::min(block.size(), result.size() - start);
+		audioClip.readBlock(start, gsl::span<float>(block.data(), blockSize));
+		std::transform(block.begin(), block.begin() + blockSize, result.begin() + start, floatSampleToInt16);
 	}
 	return result;
 }
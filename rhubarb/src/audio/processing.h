@@ -2,9 +2,22 @@
 
 #include <vector>
 #include <functional>
+#include <algorithm>
 #include "AudioClip.h"
 #include "tools/progress.h"
 
+// Converts a float in the range -1..1 to a signed 16-bit int
+inline int16_t floatSampleToInt16(float sample) {
+	sample = std::max(sample, -1.0f);
+	sample = std::min(sample, 1.0f);
+	return static_cast<int16_t>(((sample + 1) / 2) * (INT16_MAX - INT16_MIN) + INT16_MIN);
+}
+
+// Converts a signed 16-bit int to a float in the range -1..1
+inline float int16ToFloatSample(int16_t sample) {
+	return (static_cast<float>(sample) - INT16_MIN) / (INT16_MAX - INT16_MIN) * 2 - 1;
+}
+
 void process16bitAudioClip(
 	const AudioClip& audioClip,
 	const std::function<void(const std::vector<int16_t>&)>& processBuffer,
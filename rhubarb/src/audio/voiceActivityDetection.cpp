@@ -1,13 +1,15 @@
 #include "voiceActivityDetection.h"
+#include <algorithm>
+#include <iterator>
 #include "DcOffset.h"
 #include "SampleRateConverter.h"
+#include "AudioSegment.h"
 #include "logging/logging.h"
-#include "tools/pairs.h"
 #include <boost/range/adaptor/transformed.hpp>
 #include <webrtc/common_audio/vad/include/webrtc_vad.h>
 #include "processing.h"
-#include <gsl_util.h>
 #include "tools/parallel.h"
+#include "tools/profiling.h"
 #include <webrtc/common_audio/vad/vad_core.h>
 
 using std::vector;
@@ -15,73 +17,143 @@ using boost::adaptors::transformed;
 using fmt::format;
 using std::runtime_error;
 using std::unique_ptr;
+using std::invalid_argument;
+using boost::optional;
+using std::function;
 
-JoiningBoundedTimeline<void> detectVoiceActivity(
-	const AudioClip& inputAudioClip,
-	ProgressSink& progressSink
-) {
-	// Prepare audio for VAD
-	constexpr int webRtcSamplingRate = 8000;
-	const unique_ptr<AudioClip> audioClip = inputAudioClip.clone()
-		| resample(webRtcSamplingRate)
-		| removeDcOffset();
+// Activity separated by no more than this gap is merged into a single segment
+constexpr centiseconds maxGap(10);
+
+// Shorter segments of activity are discarded
+constexpr centiseconds minSegmentLength(5);
+
+// Long recordings are analyzed in chunks of this length
+constexpr centiseconds chunkLength(60 * 100);
 
-	VadInst* vadHandle = WebRtcVad_Create();
+// The VAD adapts to the noise level over time. To get nearly the same results as for a single
+// pass, the analysis of each chunk starts this much earlier.
+constexpr centiseconds chunkWarmUp(2 * 100);
+
+lambda_unique_ptr<VadInst> createVadHandle(int sampleRate) {
+	lambda_unique_ptr<VadInst> vadHandle(WebRtcVad_Create(), [](VadInst* handle) { WebRtcVad_Free(handle); });
 	if (!vadHandle) throw runtime_error("Error creating WebRTC VAD handle.");
 
-	auto freeHandle = gsl::finally([&]() { WebRtcVad_Free(vadHandle); });
+	// WebRTC is picky regarding sample rate and frame size
+	if (WebRtcVad_ValidRateAndFrameLength(sampleRate, sampleRate / 100)) {
+		throw invalid_argument(format("Unsupported sample rate for VAD: {} Hz.", sampleRate));
+	}
 
-	int error = WebRtcVad_Init(vadHandle);
+	int error = WebRtcVad_Init(vadHandle.get());
 	if (error) throw runtime_error("Error initializing WebRTC VAD.");
 
 	const int aggressiveness = 2; // 0..3. The higher, the more is cut off.
-	error = WebRtcVad_set_mode(vadHandle, aggressiveness);
+	error = WebRtcVad_set_mode(vadHandle.get(), aggressiveness);
 	if (error) throw runtime_error("Error setting WebRTC VAD aggressiveness.");
 
-	// Detect activity
-	JoiningBoundedTimeline<void> activity(audioClip->getTruncatedRange());
-	centiseconds time = 0_cs;
-	const size_t frameSize = webRtcSamplingRate / 100;
-	const auto processBuffer = [&](const vector<int16_t>& buffer) {
-		// WebRTC is picky regarding buffer size
-		if (buffer.size() < frameSize) return;
+	return vadHandle;
+}
 
-		const int result = WebRtcVad_Process(
-			vadHandle,
-			webRtcSamplingRate,
-			buffer.data(),
-			buffer.size()
-		);
-		if (result == -1) throw runtime_error("Error processing audio buffer using WebRTC VAD.");
+// Processes a 10ms frame. Returns whether it contains voice activity.
+bool isFrameActive(VadInst& vadHandle, int sampleRate, gsl::span<const int16_t> frame) {
+	const int result = WebRtcVad_Process(&vadHandle, sampleRate, frame.data(), frame.size());
+	if (result == -1) throw runtime_error("Error processing audio buffer using WebRTC VAD.");
 
-		// Ignore the result of WebRtcVad_Process, instead directly interpret the internal VAD flag.
-		// The result of WebRtcVad_Process stays 1 for a number of frames after the last detected
-		// activity.
-		const bool isActive = reinterpret_cast<VadInstT*>(vadHandle)->vad == 1;
+	// Ignore the result of WebRtcVad_Process, instead directly interpret the internal VAD flag.
+	// The result of WebRtcVad_Process stays 1 for a number of frames after the last detected
+	// activity.
+	return reinterpret_cast<VadInstT*>(&vadHandle)->vad == 1;
+}
 
-		if (isActive) {
-			activity.set(time, time + 1_cs);
-		}
+// Determines for each 10ms frame within the time range whether it contains voice activity
+void detectFrameActivity(const AudioClip& audioClip, TimeRange timeRange, vector<uint8_t>& frameActivity) {
+	profiling::ScopedTimer timer("VAD");
 
-		time += 1_cs;
-	};
-	process16bitAudioClip(*audioClip, processBuffer, frameSize, progressSink);
+	const int sampleRate = audioClip.getSampleRate();
+	const size_t frameSize = sampleRate / 100;
+	const lambda_unique_ptr<VadInst> vadHandle = createVadHandle(sampleRate);
 
-	// Fill small gaps in activity
-	const centiseconds maxGap(10);
-	for (const auto& pair : getPairs(activity)) {
-		if (pair.second.getStart() - pair.first.getEnd() <= maxGap) {
-			activity.set(pair.first.getEnd(), pair.second.getStart());
+	const centiseconds analysisStart = std::max(timeRange.getStart() - chunkWarmUp, 0_cs);
+	const vector<int16_t> samples =
+		copyTo16bitBuffer(*(audioClip.clone() | segment(TimeRange(analysisStart, timeRange.getEnd()))));
+	centiseconds time = analysisStart;
+	for (size_t frameStart = 0; frameStart + frameSize <= samples.size(); frameStart += frameSize) {
+		const bool isActive =
+			isFrameActive(*vadHandle, sampleRate, gsl::span<const int16_t>(&samples[frameStart], frameSize));
+		if (time >= timeRange.getStart()) {
+			frameActivity[time.count()] = isActive;
 		}
+		time += 1_cs;
 	}
+}
 
-	// Discard very short segments of activity
-	const centiseconds minSegmentLength(5);
-	for (const auto& segment : Timeline<void>(activity)) {
-		if (segment.getDuration() < minSegmentLength) {
-			activity.clear(segment.getTimeRange());
+constexpr int webRtcSamplingRate = 8000;
+
+void detectVoiceActivity(
+	const AudioClip& inputAudioClip,
+	int maxThreadCount,
+	ProgressSink& progressSink,
+	const function<void(const TimeRange&)>& handleSegment
+) {
+	if (maxThreadCount < 1) {
+		throw invalid_argument(format("maxThreadCount cannot be {}.", maxThreadCount));
+	}
+
+	// Prepare audio for VAD
+	const unique_ptr<AudioClip> audioClip = inputAudioClip.clone()
+		| resample(webRtcSamplingRate)
+		| removeDcOffset();
+
+	// Determine the activity of each complete 10ms frame, analyzing chunks in parallel.
+	// Each chunk writes a separate range of frames.
+	const centiseconds frameCount(audioClip->size() / (webRtcSamplingRate / 100));
+	vector<uint8_t> frameActivity(frameCount.count());
+	vector<TimeRange> chunks;
+	for (centiseconds start = 0_cs; start < frameCount; start += chunkLength) {
+		chunks.emplace_back(start, std::min(start + chunkLength, frameCount));
+	}
+
+	// Analyze as many chunks at a time as there are threads. Before analyzing the next ones, report
+	// the segments found so far, so they can be processed in the meantime. VAD takes precedence
+	// over that processing.
+	VoiceActivitySegmenter segmenter;
+	const auto reportSegment = [&](const optional<TimeRange>& segment) {
+		if (segment) {
+			handleSegment(*segment);
 		}
+	};
+	const size_t groupSize = static_cast<size_t>(maxThreadCount);
+	for (size_t groupStart = 0; groupStart < chunks.size(); groupStart += groupSize) {
+		vector<TimeRange> group(
+			chunks.begin() + groupStart,
+			chunks.begin() + std::min(groupStart + groupSize, chunks.size())
+		);
+		runParallel(
+			[&](const TimeRange& chunk) { detectFrameActivity(*audioClip, chunk, frameActivity); },
+			group,
+			maxThreadCount,
+			[](const TimeRange&) { return 1.0; }
+		);
+
+		for (centiseconds time = group.front().getStart(); time < group.back().getEnd(); time += 1_cs) {
+			reportSegment(segmenter.addFrame(frameActivity[time.count()] != 0));
+		}
+		progressSink.reportProgress(
+			static_cast<double>(group.back().getEnd().count()) / frameCount.count()
+		);
 	}
+	reportSegment(segmenter.close());
+	progressSink.reportProgress(1.0);
+}
+
+JoiningBoundedTimeline<void> detectVoiceActivity(
+	const AudioClip& audioClip,
+	int maxThreadCount,
+	ProgressSink& progressSink
+) {
+	JoiningBoundedTimeline<void> activity((audioClip.clone() | resample(webRtcSamplingRate))->getTruncatedRange());
+	detectVoiceActivity(audioClip, maxThreadCount, progressSink, [&](const TimeRange& segment) {
+		activity.set(segment.getStart(), segment.getEnd());
+	});
 
 	logging::debugFormat(
 		"Found {} sections of voice activity: {}",
@@ -93,3 +165,91 @@ JoiningBoundedTimeline<void> detectVoiceActivity(
 
 	return activity;
 }
+
+VoiceActivitySegmenter::VoiceActivitySegmenter(optional<centiseconds> maxSegmentLength) :
+	maxSegmentLength(maxSegmentLength)
+{}
+
+optional<TimeRange> VoiceActivitySegmenter::addFrame(bool isActive) {
+	if (isActive) {
+		// Any gap since the end of the open segment is small enough to be filled
+		openSegment = openSegment
+			? TimeRange(openSegment->getStart(), time + 1_cs)
+			: TimeRange(time, time + 1_cs);
+	}
+
+	time += 1_cs;
+
+	if (!openSegment) return boost::none;
+
+	// Once the gap after the open segment has grown too large to be filled, the segment is complete
+	const bool gapTooLarge = time - openSegment->getEnd() > maxGap;
+	const bool segmentTooLong = maxSegmentLength && time - openSegment->getStart() >= *maxSegmentLength;
+	return gapTooLarge || segmentTooLong ? closeSegment() : boost::none;
+}
+
+optional<TimeRange> VoiceActivitySegmenter::close() {
+	return closeSegment();
+}
+
+optional<centiseconds> VoiceActivitySegmenter::getOpenSegmentStart() const {
+	return openSegment ? openSegment->getStart() : optional<centiseconds>();
+}
+
+optional<TimeRange> VoiceActivitySegmenter::closeSegment() {
+	const optional<TimeRange> segment = openSegment;
+	openSegment.reset();
+
+	// Discard very short segments of activity
+	return segment && segment->getDuration() >= minSegmentLength ? segment : boost::none;
+}
+
+VoiceActivityStream::VoiceActivityStream(int sampleRate, optional<centiseconds> maxSegmentLength) :
+	sampleRateConverter(sampleRate, webRtcSamplingRate),
+	vadHandle(createVadHandle(webRtcSamplingRate)),
+	segmenter(maxSegmentLength)
+{}
+
+vector<TimeRange> VoiceActivityStream::write(gsl::span<const float> samples) {
+	vector<float> resampledSamples;
+	sampleRateConverter.write(samples, resampledSamples);
+	vector<TimeRange> completedSegments;
+	processSamples(resampledSamples, completedSegments);
+	return completedSegments;
+}
+
+vector<TimeRange> VoiceActivityStream::close() {
+	vector<float> resampledSamples;
+	sampleRateConverter.flush(resampledSamples);
+	vector<TimeRange> completedSegments;
+	processSamples(resampledSamples, completedSegments);
+
+	// An incomplete frame at the end is ignored
+	if (const optional<TimeRange> segment = segmenter.close()) {
+		completedSegments.push_back(*segment);
+	}
+	pendingSamples.clear();
+	return completedSegments;
+}
+
+void VoiceActivityStream::processSamples(
+	const vector<float>& samples,
+	vector<TimeRange>& completedSegments
+) {
+	std::transform(samples.begin(), samples.end(), std::back_inserter(pendingSamples), floatSampleToInt16);
+
+	// Process all complete 10ms frames
+	const size_t frameSize = webRtcSamplingRate / 100;
+	size_t frameStart = 0;
+	for (; frameStart + frameSize <= pendingSamples.size(); frameStart += frameSize) {
+		const bool isActive = isFrameActive(
+			*vadHandle,
+			webRtcSamplingRate,
+			gsl::span<const int16_t>(pendingSamples.data() + frameStart, frameSize)
+		);
+		if (const optional<TimeRange> segment = segmenter.addFrame(isActive)) {
+			completedSegments.push_back(*segment);
+		}
+	}
+	pendingSamples.erase(pendingSamples.begin(), pendingSamples.begin() + frameStart);
+}
@@ -1,9 +1,93 @@
 #pragma once
+#include <functional>
+#include <boost/optional.hpp>
 #include "AudioClip.h"
+#include "SampleRateConverter.h"
 #include "time/BoundedTimeline.h"
 #include "tools/progress.h"
+#include "tools/tools.h"
 
+// Long recordings are split into chunks that are analyzed in parallel, using up to the specified
+// number of threads. The result doesn't depend on the thread count.
 JoiningBoundedTimeline<void> detectVoiceActivity(
 	const AudioClip& audioClip,
+	int maxThreadCount,
 	ProgressSink& progressSink
 );
+
+// Like detectVoiceActivity above, but passes each segment of activity to the callback as soon as
+// it is known, in chronological order
+void detectVoiceActivity(
+	const AudioClip& audioClip,
+	int maxThreadCount,
+	ProgressSink& progressSink,
+	const std::function<void(const TimeRange&)>& handleSegment
+);
+
+typedef struct WebRtcVadInst VadInst;
+
+// Turns the voice activity of consecutive 10ms frames into segments of activity.
+// Fills short gaps between segments and discards very short segments.
+class VoiceActivitySegmenter {
+public:
+	explicit VoiceActivitySegmenter(boost::optional<centiseconds> maxSegmentLength = boost::none);
+
+	// Adds the next frame. Returns the segment of activity that has ended, if any.
+	boost::optional<TimeRange> addFrame(bool isActive);
+
+	// Returns the segment of activity in progress, if any
+	boost::optional<TimeRange> close();
+
+	// Returns the end of the last frame added
+	centiseconds getTime() const {
+		return time;
+	}
+
+	// Returns the start of the segment of activity in progress, if any
+	boost::optional<centiseconds> getOpenSegmentStart() const;
+
+private:
+	boost::optional<TimeRange> closeSegment();
+
+	boost::optional<centiseconds> maxSegmentLength;
+	centiseconds time = 0_cs;
+	boost::optional<TimeRange> openSegment;
+};
+
+// Detects voice activity in audio that arrives incrementally, resampling it for the VAD like
+// detectVoiceActivity does. Segments are reported as soon as they are complete.
+// detectVoiceActivity additionally removes any DC offset, which requires the first seconds of
+// audio. So without a maximum segment length, the segments are identical to those found by
+// detectVoiceActivity for the same audio if the audio has no DC offset.
+class VoiceActivityStream {
+public:
+	VoiceActivityStream(
+		int sampleRate,
+		boost::optional<centiseconds> maxSegmentLength = boost::none
+	);
+
+	// Processes the specified samples. Returns all segments of activity that have ended.
+	std::vector<TimeRange> write(gsl::span<const float> samples);
+
+	// Ends the stream. Returns the segment of activity in progress, if any.
+	std::vector<TimeRange> close();
+
+	// Returns the time up to which audio has been analyzed
+	centiseconds getTime() const {
+		return segmenter.getTime();
+	}
+
+	// Returns the start of the segment of activity in progress, if any
+	boost::optional<centiseconds> getOpenSegmentStart() const {
+		return segmenter.getOpenSegmentStart();
+	}
+
+private:
+	void processSamples(const std::vector<float>& samples, std::vector<TimeRange>& completedSegments);
+
+	StreamingSampleRateConverter sampleRateConverter;
+	lambda_unique_ptr<VadInst> vadHandle;
+	// Resampled samples of an incomplete frame from the previous write
+	std::vector<int16_t> pendingSamples;
+	VoiceActivitySegmenter segmenter;
+};
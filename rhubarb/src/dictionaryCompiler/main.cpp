@@ -0,0 +1,22 @@
+#include <iostream>
+#include "recognition/PronunciationDictionary.h"
+#include "tools/exceptions.h"
+
+using std::filesystem::u8path;
+
+// Converts a pronunciation dictionary in CMU Sphinx text format to the binary format that Rhubarb
+// loads at runtime.
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		std::cerr << "Usage: rhubarb-dictionary-compiler <text dictionary> <binary dictionary>" << std::endl;
+		return 1;
+	}
+
+	try {
+		PronunciationDictionary::compile(u8path(argv[1]), u8path(argv[2]));
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Error compiling pronunciation dictionary: " << getMessage(e) << std::endl;
+		return 1;
+	}
+}
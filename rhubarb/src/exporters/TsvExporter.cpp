@@ -18,3 +18,36 @@ void TsvExporter::exportAnimation(const ExporterInput& input, std::ostream& outp
 		<< convertToTargetShapeSet(Shape::X, input.targetShapeSet)
 		<< "\n";
 }
+
+TsvStreamExporter::TsvStreamExporter(const ShapeSet& targetShapeSet, std::ostream& outputStream) :
+	targetShapeSet(targetShapeSet),
+	outputStream(outputStream)
+{}
+
+void TsvStreamExporter::exportAnimation(const JoiningContinuousTimeline<Shape>& animation) {
+	// Output shapes with start times, joining shapes across calls
+	for (auto& timedShape : animation) {
+		if (previousShape && timedShape.getValue() == *previousShape) continue;
+
+		outputStream
+			<< formatDuration(timedShape.getStart())
+			<< "\t"
+			<< timedShape.getValue()
+			<< "\n";
+		previousShape = timedShape.getValue();
+	}
+	endTime = std::max(endTime, animation.getRange().getEnd());
+
+	// Make each part available right away
+	outputStream.flush();
+}
+
+void TsvStreamExporter::finish() {
+	// Output closed mouth with end time
+	outputStream
+		<< formatDuration(endTime)
+		<< "\t"
+		<< convertToTargetShapeSet(Shape::X, targetShapeSet)
+		<< "\n";
+	outputStream.flush();
+}
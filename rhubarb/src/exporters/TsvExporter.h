@@ -1,9 +1,27 @@
 #pragma once
 
 #include "Exporter.h"
+#include <boost/optional.hpp>
 
 class TsvExporter : public Exporter {
 public:
 	void exportAnimation(const ExporterInput& input, std::ostream& outputStream) override;
 };
 
+// Writes the same output as TsvExporter, but part by part as the animation becomes known
+class TsvStreamExporter {
+public:
+	TsvStreamExporter(const ShapeSet& targetShapeSet, std::ostream& outputStream);
+
+	// Exports the animation directly following the previously exported one
+	void exportAnimation(const JoiningContinuousTimeline<Shape>& animation);
+
+	// Ends the output
+	void finish();
+
+private:
+	ShapeSet targetShapeSet;
+	std::ostream& outputStream;
+	boost::optional<Shape> previousShape;
+	centiseconds endTime = 0_cs;
+};
@@ -3,10 +3,16 @@
 #include "tools/textFiles.h"
 #include "animation/mouthAnimation.h"
 #include "audio/audioFileReading.h"
+#include "audio/processing.h"
+#include "animation/StreamingAnimator.h"
+#include "tools/profiling.h"
 
 using boost::optional;
 using std::string;
 using std::filesystem::path;
+using std::vector;
+using std::unique_ptr;
+using std::function;
 
 JoiningContinuousTimeline<Shape> animateAudioClip(
 	const AudioClip& audioClip,
@@ -16,8 +22,10 @@ JoiningContinuousTimeline<Shape> animateAudioClip(
 	int maxThreadCount,
 	ProgressSink& progressSink)
 {
-	const BoundedTimeline<Phone> phones =
-		recognizer.recognizePhones(audioClip, dialog, maxThreadCount, progressSink);
+	const BoundedTimeline<Phone> phones = [&] {
+		profiling::ScopedTimer timer("recognition");
+		return recognizer.recognizePhones(audioClip, dialog, maxThreadCount, progressSink);
+	}();
 	JoiningContinuousTimeline<Shape> result = animate(phones, targetShapeSet);
 	return result;
 }
@@ -30,6 +38,52 @@ JoiningContinuousTimeline<Shape> animateWaveFile(
 	int maxThreadCount,
 	ProgressSink& progressSink)
 {
+	profiling::ScopedTimer timer("file", [&] { return filePath.u8string(); });
 	const auto audioClip = createAudioFileClip(filePath);
 	return animateAudioClip(*audioClip, dialog, recognizer, targetShapeSet, maxThreadCount, progressSink);
 }
+
+void animateAudioStream(
+	std::istream& inputStream,
+	int sampleRate,
+	const optional<string>& dialog,
+	const Recognizer& recognizer,
+	const ShapeSet& targetShapeSet,
+	centiseconds maxLatency,
+	const function<void(const JoiningContinuousTimeline<Shape>&)>& handleAnimation)
+{
+	if (sampleRate <= 0) throw std::invalid_argument("Sample rate must be positive.");
+
+	// The animation lags behind the recognized phones, which in turn lag behind the audio
+	const unique_ptr<PhoneStream> phoneStream =
+		recognizer.createPhoneStream(sampleRate, dialog, maxLatency - StreamingAnimator::lookahead);
+	StreamingAnimator animator(targetShapeSet);
+
+	// Read blocks of 10ms
+	const size_t blockSampleCount = std::max(sampleRate / 100, 1);
+	vector<char> bytes(blockSampleCount * 2);
+	vector<float> samples;
+	int64_t sampleCount = 0;
+	while (inputStream) {
+		inputStream.read(bytes.data(), bytes.size());
+		samples.resize(static_cast<size_t>(inputStream.gcount() / 2));
+		for (size_t i = 0; i < samples.size(); ++i) {
+			const auto sample = static_cast<int16_t>(
+				static_cast<uint8_t>(bytes[2 * i]) | static_cast<uint8_t>(bytes[2 * i + 1]) << 8
+			);
+			samples[i] = int16ToFloatSample(sample);
+		}
+		sampleCount += samples.size();
+
+		const Timeline<Phone> phones = phoneStream->write(samples);
+		const JoiningContinuousTimeline<Shape> animation =
+			animator.update(phones, phoneStream->getCompletedTime());
+		if (!animation.getRange().empty()) {
+			handleAnimation(animation);
+		}
+	}
+	if (inputStream.bad()) throw std::runtime_error("Error reading audio stream.");
+
+	const centiseconds endTime(static_cast<int>(sampleCount * 100 / sampleRate));
+	handleAnimation(animator.finish(phoneStream->close(), endTime));
+}
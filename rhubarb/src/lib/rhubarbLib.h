@@ -5,6 +5,8 @@
 #include "audio/AudioClip.h"
 #include "tools/progress.h"
 #include <filesystem>
+#include <functional>
+#include <istream>
 #include "animation/targetShapeSet.h"
 #include "recognition/Recognizer.h"
 
@@ -23,3 +25,15 @@ JoiningContinuousTimeline<Shape> animateWaveFile(
 	const ShapeSet& targetShapeSet,
 	int maxThreadCount,
 	ProgressSink& progressSink);
+
+// Animates raw audio (16-bit signed little-endian mono) as it is read from the input stream.
+// Calls the handler with each consecutive part of the animation as soon as it is final, which is
+// no later than maxLatency after the corresponding audio has been read.
+void animateAudioStream(
+	std::istream& inputStream,
+	int sampleRate,
+	const boost::optional<std::string>& dialog,
+	const Recognizer& recognizer,
+	const ShapeSet& targetShapeSet,
+	centiseconds maxLatency,
+	const std::function<void(const JoiningContinuousTimeline<Shape>&)>& handleAnimation);
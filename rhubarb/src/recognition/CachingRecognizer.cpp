@@ -0,0 +1,204 @@
+#include "CachingRecognizer.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <format.h>
+#include "audio/ioTools.h"
+#include "audio/processing.h"
+#include "core/appInfo.h"
+#include "logging/logging.h"
+#include "tools/exceptions.h"
+#include "tools/profiling.h"
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::runtime_error;
+using std::filesystem::path;
+using boost::optional;
+using namespace little_endian;
+
+constexpr uint32_t cacheFileMagic = fourcc('R', 'L', 'S', 'P');
+// Increase whenever the file format changes
+constexpr uint32_t cacheFileVersion = 1;
+
+// 64-bit FNV-1a
+class ContentHash {
+public:
+	void add(const void* data, size_t size) {
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			value = (value ^ bytes[i]) * 0x100000001b3;
+		}
+	}
+
+	template<typename T>
+	void add(T value) {
+		static_assert(std::is_arithmetic<T>::value, "Only numbers can be added directly.");
+		add(&value, sizeof value);
+	}
+
+	void add(const string& s) {
+		add(static_cast<uint64_t>(s.size()));
+		add(s.data(), s.size());
+	}
+
+	uint64_t get() const {
+		return value;
+	}
+
+private:
+	uint64_t value = 0xcbf29ce484222325;
+};
+
+CachingRecognizer::CachingRecognizer(
+	unique_ptr<Recognizer> recognizer,
+	string recognizerKey,
+	path cacheDirectory
+) :
+	recognizer(std::move(recognizer)),
+	recognizerKey(std::move(recognizerKey)),
+	cacheDirectory(std::move(cacheDirectory))
+{}
+
+path CachingRecognizer::getCacheFilePath(const AudioClip& audioClip, const optional<string>& dialog) const {
+	ContentHash hash;
+	hash.add(appVersion);
+	hash.add(recognizerKey);
+	hash.add(static_cast<uint8_t>(dialog ? 1 : 0));
+	if (dialog) {
+		hash.add(*dialog);
+	}
+
+	// Hash the audio as 16-bit PCM
+	hash.add(static_cast<int32_t>(audioClip.getSampleRate()));
+	hash.add(static_cast<int64_t>(audioClip.size()));
+	constexpr AudioClip::size_type blockSize = 64 * 1024;
+	vector<AudioClip::value_type> block;
+	vector<int16_t> pcmBlock;
+	for (AudioClip::size_type start = 0; start < audioClip.size(); start += blockSize) {
+		block.resize(static_cast<size_t>(std::min(blockSize, audioClip.size() - start)));
+		audioClip.readBlock(start, block);
+		pcmBlock.resize(block.size());
+		std::transform(block.begin(), block.end(), pcmBlock.begin(), floatSampleToInt16);
+		hash.add(pcmBlock.data(), pcmBlock.size() * sizeof(int16_t));
+	}
+
+	return cacheDirectory / fmt::format("{:016x}.phones", hash.get());
+}
+
+BoundedTimeline<Phone> CachingRecognizer::recognizePhones(
+	const AudioClip& audioClip,
+	optional<string> dialog,
+	int maxThreadCount,
+	ProgressSink& progressSink
+) const {
+	const path cacheFilePath = [&] {
+		profiling::ScopedTimer timer("cache lookup");
+		return getCacheFilePath(audioClip, dialog);
+	}();
+
+	if (std::filesystem::exists(cacheFilePath)) {
+		try {
+			std::ifstream file;
+			file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+			file.open(cacheFilePath, std::ios::binary);
+			BoundedTimeline<Phone> phones = readPhones(file);
+			profiling::count("cache hits");
+			logging::debugFormat("Using cached phones from {}.", cacheFilePath.u8string());
+			progressSink.reportProgress(1.0);
+			return phones;
+		} catch (const std::exception& e) {
+			logging::warnFormat(
+				"Ignoring unreadable cache file {}: {}", cacheFilePath.u8string(), getMessage(e)
+			);
+		}
+	}
+	profiling::count("cache misses");
+
+	BoundedTimeline<Phone> phones =
+		recognizer->recognizePhones(audioClip, dialog, maxThreadCount, progressSink);
+
+	// Write to a temporary file first, so that concurrent readers never see a partial entry
+	const path tempFilePath = path(cacheFilePath).concat(fmt::format(".{:08x}.tmp", std::random_device()()));
+	try {
+		std::filesystem::create_directories(cacheDirectory);
+		{
+			std::ofstream file;
+			file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+			file.open(tempFilePath, std::ios::binary);
+			writePhones(phones, file);
+		}
+		std::filesystem::rename(tempFilePath, cacheFilePath);
+	} catch (const std::exception& e) {
+		logging::warnFormat("Error writing cache file {}: {}", cacheFilePath.u8string(), getMessage(e));
+		std::error_code errorCode;
+		std::filesystem::remove(tempFilePath, errorCode);
+	}
+
+	return phones;
+}
+
+unique_ptr<PhoneStream> CachingRecognizer::createPhoneStream(
+	int sampleRate,
+	optional<string> dialog,
+	centiseconds maxDelay
+) const {
+	return recognizer->createPhoneStream(sampleRate, dialog, maxDelay);
+}
+
+void writePhones(const BoundedTimeline<Phone>& phones, std::ostream& stream) {
+	write<uint32_t>(cacheFileMagic, stream);
+	write<uint32_t>(cacheFileVersion, stream);
+	write<int32_t>(static_cast<int32_t>(phones.getRange().getStart().count()), stream);
+	write<int32_t>(static_cast<int32_t>(phones.getRange().getEnd().count()), stream);
+	write<uint32_t>(static_cast<uint32_t>(phones.size()), stream);
+
+	// Store each phone relative to the end of the previous one
+	centiseconds previousEnd = phones.getRange().getStart();
+	for (const Timed<Phone>& timedPhone : phones) {
+		write<int32_t>(static_cast<int32_t>((timedPhone.getStart() - previousEnd).count()), stream);
+		write<int32_t>(static_cast<int32_t>(timedPhone.getDuration().count()), stream);
+		write<uint8_t>(static_cast<uint8_t>(timedPhone.getValue()), stream);
+		previousEnd = timedPhone.getEnd();
+	}
+}
+
+BoundedTimeline<Phone> readPhones(std::istream& stream) {
+	if (read<uint32_t>(stream) != cacheFileMagic) {
+		throw runtime_error("Not a phone cache file.");
+	}
+	const uint32_t version = read<uint32_t>(stream);
+	if (version != cacheFileVersion) {
+		throw runtime_error(fmt::format("Unsupported phone cache file version {}.", version));
+	}
+	const centiseconds rangeStart(read<int32_t>(stream));
+	const centiseconds rangeEnd(read<int32_t>(stream));
+	if (rangeEnd < rangeStart) {
+		throw runtime_error("Invalid time range in cache file.");
+	}
+	BoundedTimeline<Phone> phones(TimeRange(rangeStart, rangeEnd));
+	const uint32_t phoneCount = read<uint32_t>(stream);
+
+	const int maxPhone = static_cast<int>(Phone::Noise);
+	centiseconds previousEnd = rangeStart;
+	for (uint32_t i = 0; i < phoneCount; ++i) {
+		const centiseconds delta(read<int32_t>(stream));
+		const centiseconds duration(read<int32_t>(stream));
+		if (delta < 0_cs || duration < 0_cs) {
+			throw runtime_error(fmt::format(
+				"Invalid timing for phone {} in cache file: offset {}, duration {}.",
+				i, delta.count(), duration.count()
+			));
+		}
+		const centiseconds start = previousEnd + delta;
+		const centiseconds end = start + duration;
+		const int phone = read<uint8_t>(stream);
+		if (phone > maxPhone) {
+			throw runtime_error("Invalid phone in cache file.");
+		}
+		phones.set(start, end, static_cast<Phone>(phone));
+		previousEnd = end;
+	}
+	return phones;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include "Recognizer.h"
+
+// Keeps the phones recognized by another recognizer in a directory, so that processing the same
+// input again skips speech recognition. Entries are keyed by a hash of the audio samples, the
+// dialog, the recognizer and the application version. Streams aren't cached.
+class CachingRecognizer : public Recognizer {
+public:
+	// The recognizer key must identify the recognizer and every setting that affects its results
+	CachingRecognizer(
+		std::unique_ptr<Recognizer> recognizer,
+		std::string recognizerKey,
+		std::filesystem::path cacheDirectory
+	);
+
+	BoundedTimeline<Phone> recognizePhones(
+		const AudioClip& audioClip,
+		boost::optional<std::string> dialog,
+		int maxThreadCount,
+		ProgressSink& progressSink
+	) const override;
+
+	std::unique_ptr<PhoneStream> createPhoneStream(
+		int sampleRate,
+		boost::optional<std::string> dialog,
+		centiseconds maxDelay
+	) const override;
+
+private:
+	std::filesystem::path getCacheFilePath(
+		const AudioClip& audioClip,
+		const boost::optional<std::string>& dialog
+	) const;
+
+	std::unique_ptr<Recognizer> recognizer;
+	std::string recognizerKey;
+	std::filesystem::path cacheDirectory;
+};
+
+// Binary format of the cache entries
+void writePhones(const BoundedTimeline<Phone>& phones, std::ostream& stream);
+BoundedTimeline<Phone> readPhones(std::istream& stream);
@@ -1,17 +1,18 @@
 #include "PhoneticRecognizer.h"
 #include "time/Timeline.h"
-#include "audio/AudioSegment.h"
-#include "audio/SampleRateConverter.h"
-#include "audio/processing.h"
 #include "time/timedLogging.h"
+#include "tools/profiling.h"
 
 using std::runtime_error;
 using std::unique_ptr;
 using std::string;
 using boost::optional;
 
-static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialog) {
-	UNUSED(dialog);
+static lambda_unique_ptr<ps_decoder_t> createDecoder(PhoneticQuality quality) {
+	profiling::ScopedTimer timer("decoder creation");
+	profiling::count("decoders created");
+
+	const bool isDraft = quality == PhoneticQuality::Draft;
 
 	lambda_unique_ptr<cmd_ln_t> config(
 		cmd_ln_init(
@@ -21,6 +22,8 @@ static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialo
 			// Set phonetic language model
 			"-allphone", (getSphinxModelDirectory() / "en-us-phone.lm.bin").u8string().c_str(),
 			"-allphone_ci", "yes",
+			// Score phone transitions by bigrams rather than trigrams in draft quality
+			"-allphone_bg", isDraft ? "yes" : "no",
 			// Set language model probability weight.
 			// Low values (<= 0.4) can lead to fluttering animation.
 			// High values (>= 1.0) can lead to imprecise or freezing animation.
@@ -37,9 +40,15 @@ static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialo
 			// http://cmusphinx.sourceforge.net/wiki/phonemerecognition
 
 			// Set beam width applied to every frame in Viterbi search
-			"-beam", "1e-20",
+			"-beam", isDraft ? "1e-5" : "1e-20",
 			// Set beam width applied to phone transitions
-			"-pbeam", "1e-20",
+			"-pbeam", isDraft ? "1e-5" : "1e-20",
+
+			// Set number of Gaussians per codebook used for scoring
+			"-topn", isDraft ? "1" : "4",
+			// Set how often all codebooks are evaluated. In between, only the previous frame's
+			// top Gaussians are.
+			"-ds", isDraft ? "2" : "1",
 			nullptr),
 		[](cmd_ln_t* config) { cmd_ln_free_r(config); });
 	if (!config) throw runtime_error("Error creating configuration.");
@@ -53,7 +62,7 @@ static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialo
 }
 
 static Timeline<Phone> utteranceToPhones(
-	const AudioClip& audioClip,
+	const MemoryAudioClip& audioClip,
 	TimeRange utteranceTimeRange,
 	ps_decoder_t& decoder,
 	ProgressSink& utteranceProgressSink
@@ -64,13 +73,11 @@ static Timeline<Phone> utteranceToPhones(
 	paddedTimeRange.grow(padding);
 	paddedTimeRange.trim(audioClip.getTruncatedRange());
 
-	const unique_ptr<AudioClip> clipSegment = audioClip.clone()
-		| segment(paddedTimeRange)
-		| resample(sphinxSampleRate);
-	const auto audioBuffer = copyTo16bitBuffer(*clipSegment);
+	const MemoryAudioClip clipSegment = audioClip.getSegment(paddedTimeRange);
+	const gsl::span<const int16_t> audioBuffer = clipSegment.getSamples();
 
 	// Detect phones (returned as words)
-	BoundedTimeline<string> phoneStrings = recognizeWords(audioBuffer, decoder);
+	BoundedTimeline<string> phoneStrings = recognizeWords(UtteranceCepstra(audioBuffer, decoder), decoder);
 	phoneStrings.shift(paddedTimeRange.getStart());
 	Timeline<Phone> utterancePhones;
 	for (const auto& timedPhoneString : phoneStrings) {
@@ -103,11 +110,40 @@ static Timeline<Phone> utteranceToPhones(
 	return utterancePhones;
 }
 
+PhoneticRecognizer::PhoneticRecognizer(centiseconds maxUtteranceLength, PhoneticQuality quality) :
+	maxUtteranceLength(maxUtteranceLength),
+	quality(quality),
+	decoderPool([quality] { return createDecoder(quality); })
+{}
+
+decoderFactory PhoneticRecognizer::getDecoderFactory() const {
+	// The phone language model doesn't depend on the dialog
+	const PhoneticQuality quality = this->quality;
+	return [quality](const optional<string>&) { return createDecoder(quality); };
+}
+
 BoundedTimeline<Phone> PhoneticRecognizer::recognizePhones(
 	const AudioClip& inputAudioClip,
 	optional<std::string> dialog,
 	int maxThreadCount,
 	ProgressSink& progressSink
 ) const {
-	return ::recognizePhones(inputAudioClip, dialog, &createDecoder, &utteranceToPhones, maxThreadCount, progressSink);
+	return ::recognizePhones(
+		inputAudioClip,
+		dialog,
+		decoderPool,
+		getDecoderFactory(),
+		&utteranceToPhones,
+		maxUtteranceLength,
+		maxThreadCount,
+		progressSink
+	);
+}
+
+unique_ptr<PhoneStream> PhoneticRecognizer::createPhoneStream(
+	int sampleRate,
+	optional<std::string> dialog,
+	centiseconds maxDelay
+) const {
+	return ::createPhoneStream(sampleRate, dialog, maxDelay, getDecoderFactory(), &utteranceToPhones);
 }
@@ -1,17 +1,19 @@
 #include "PocketSphinxRecognizer.h"
 #include <regex>
+#include <mutex>
+#include <unordered_map>
 #include <gsl_util.h>
-#include "audio/AudioSegment.h"
-#include "audio/SampleRateConverter.h"
 #include "languageModels.h"
+#include "PronunciationDictionary.h"
 #include "tokenization.h"
 #include "g2p.h"
 #include "time/ContinuousTimeline.h"
-#include "audio/processing.h"
 #include "time/timedLogging.h"
+#include "tools/profiling.h"
 
 extern "C" {
 #include <state_align_search.h>
+#include <ptm_mgau.h>
 }
 
 using std::runtime_error;
@@ -36,16 +38,85 @@ s3wid_t getWordId(const string& word, dict_t& dictionary) {
 	return wordId;
 }
 
+// Returns the guessed pronunciation of a word that's missing from the dictionary.
+// Guesses are cached for the lifetime of the process: Each decoder needs them, and the same
+// names tend to recur across recognition jobs.
+string guessPronunciation(const string& word) {
+	static std::mutex mutex;
+	static std::unordered_map<string, string> cache;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const auto it = cache.find(word);
+		if (it != cache.end()) return it->second;
+	}
+
+	string pronunciation;
+	for (Phone phone : wordToPhones(word)) {
+		if (pronunciation.length() > 0) pronunciation += " ";
+		pronunciation += PhoneConverter::get().toString(phone);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	cache.emplace(word, pronunciation);
+	return pronunciation;
+}
+
+// Returns the full pronunciation dictionary, which is shared by all decoders.
+// Each decoder only gets the words its language model knows, since the search ignores all others.
+// This saves most of the memory and setup time per decoder.
+const PronunciationDictionary& getPronunciationDictionary() {
+	static const PronunciationDictionary dictionary(getSphinxModelDirectory() / "cmudict-en-us.bin");
+	return dictionary;
+}
+
+// Adds all words the language model knows, including alternative pronunciations,
+// to the decoder's dictionary
+void addDictionaryWords(ngram_model_t& languageModel, ps_decoder_t& decoder) {
+	const PronunciationDictionary& dictionary = getPronunciationDictionary();
+	vector<bool> isUsed(dictionary.getEntryCount(), false);
+	for (int32 i = 0; const char* word = ngram_word(&languageModel, i); ++i) {
+		if (const optional<int> entryIndex = dictionary.find(word)) {
+			isUsed[*entryIndex] = true;
+		}
+	}
+
+	vector<s3cipid_t> phoneIds;
+	for (const string& phoneName : dictionary.getPhoneNames()) {
+		const int phoneId = bin_mdef_ciphone_id(decoder.acmod->mdef, phoneName.c_str());
+		if (phoneId < 0) {
+			throw runtime_error(fmt::format(
+				"Dictionary phone '{}' is missing in the acoustic model.",
+				phoneName
+			));
+		}
+		phoneIds.push_back(static_cast<s3cipid_t>(phoneId));
+	}
+
+	// Keep the original word order, so that base words precede their alternatives
+	vector<s3cipid_t> pronunciation;
+	for (int entryIndex = 0; entryIndex < dictionary.getEntryCount(); ++entryIndex) {
+		if (!isUsed[dictionary.getBaseEntryIndex(entryIndex)]) continue;
+
+		pronunciation.clear();
+		for (uint8_t phoneIndex : dictionary.getPronunciation(entryIndex)) {
+			pronunciation.push_back(phoneIds[phoneIndex]);
+		}
+		const string word(dictionary.getWord(entryIndex));
+		const s3wid_t wordId = dict_add_word(
+			decoder.dict, word.c_str(), pronunciation.data(), static_cast<int32>(pronunciation.size())
+		);
+		if (wordId == BAD_S3WID) {
+			throw runtime_error(fmt::format("Error adding word '{}' to dictionary.", word));
+		}
+		dict2pid_add_word(decoder.d2p, wordId);
+	}
+}
+
 void addMissingDictionaryWords(const vector<string>& words, ps_decoder_t& decoder) {
 	map<string, string> missingPronunciations;
 	for (const string& word : words) {
 		if (!dictionaryContains(*decoder.dict, word)) {
-			string pronunciation;
-			for (Phone phone : wordToPhones(word)) {
-				if (pronunciation.length() > 0) pronunciation += " ";
-				pronunciation += PhoneConverter::get().toString(phone);
-			}
-			missingPronunciations[word] = pronunciation;
+			missingPronunciations[word] = guessPronunciation(word);
 		}
 	}
 	for (auto it = missingPronunciations.begin(); it != missingPronunciations.end(); ++it) {
@@ -67,35 +138,58 @@ lambda_unique_ptr<ngram_model_t> createDefaultLanguageModel(ps_decoder_t& decode
 	return result;
 }
 
-lambda_unique_ptr<ngram_model_t> createDialogLanguageModel(
-	ps_decoder_t& decoder,
-	const string& dialog
-) {
-	// Split dialog into normalized words
-	vector<string> words = tokenizeText(
-		dialog,
-		[&](const string& word) { return dictionaryContains(*decoder.dict, word); }
-	);
+// The dialog-specific language model of a recognition job.
+// It is estimated when the first decoder is created and shared by all decoders of the job.
+class DialogLanguageModel {
+public:
+	explicit DialogLanguageModel(string dialog) :
+		dialog(std::move(dialog))
+	{}
+
+	// Returns the normalized dialog words
+	const vector<string>& getWords() {
+		initialize();
+		return words;
+	}
 
-	// Add dialog-specific words to the dictionary
-	addMissingDictionaryWords(words, decoder);
+	// Creates the language model for a decoder
+	lambda_unique_ptr<ngram_model_t> createFor(ps_decoder_t& decoder) {
+		initialize();
+		return createLanguageModel(languageModel, decoder);
+	}
 
-	// Create dialog-specific language model
-	words.insert(words.begin(), "<s>");
-	words.emplace_back("</s>");
-	return createLanguageModel(words, decoder);
-}
+private:
+	void initialize() {
+		std::call_once(initialized, [&] {
+			// Split dialog into normalized words
+			words = tokenizeText(
+				dialog,
+				[](const string& word) { return getPronunciationDictionary().contains(word); }
+			);
+
+			vector<string> sentence(words);
+			sentence.insert(sentence.begin(), "<s>");
+			sentence.emplace_back("</s>");
+			languageModel = estimateLanguageModel(sentence);
+		});
+	}
+
+	string dialog;
+	std::once_flag initialized;
+	vector<string> words;
+	NGramLanguageModel languageModel;
+};
 
 lambda_unique_ptr<ngram_model_t> createBiasedLanguageModel(
 	ps_decoder_t& decoder,
-	const string& dialog
+	DialogLanguageModel& dialogLanguageModel
 ) {
 	auto defaultLanguageModel = createDefaultLanguageModel(decoder);
-	auto dialogLanguageModel = createDialogLanguageModel(decoder, dialog);
+	auto decoderDialogLanguageModel = dialogLanguageModel.createFor(decoder);
 	constexpr int modelCount = 2;
 	array<ngram_model_t*, modelCount> languageModels {
 		defaultLanguageModel.get(),
-		dialogLanguageModel.get()
+		decoderDialogLanguageModel.get()
 	};
 	array<const char*, modelCount> modelNames { "defaultLM", "dialogLM" };
 	array<float, modelCount> modelWeights { 0.1f, 0.9f };
@@ -115,14 +209,15 @@ lambda_unique_ptr<ngram_model_t> createBiasedLanguageModel(
 	return result;
 }
 
-static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialog) {
+static lambda_unique_ptr<ps_decoder_t> createDecoder(DialogLanguageModel* dialogLanguageModel) {
+	profiling::ScopedTimer timer("decoder creation");
+	profiling::count("decoders created");
+
 	lambda_unique_ptr<cmd_ln_t> config(
 		cmd_ln_init(
 			nullptr, ps_args(), true,
 			// Set acoustic model
 			"-hmm", (getSphinxModelDirectory() / "acoustic-model").u8string().c_str(),
-			// Set pronunciation dictionary
-			"-dict", (getSphinxModelDirectory() / "cmudict-en-us.dict").u8string().c_str(),
 			// Add noise against zero silence
 			// (see http://cmusphinx.sourceforge.net/wiki/faq#qwhy_my_accuracy_is_poor)
 			"-dither", "yes",
@@ -140,22 +235,47 @@ static lambda_unique_ptr<ps_decoder_t> createDecoder(optional<std::string> dialo
 	if (!decoder) throw runtime_error("Error creating speech decoder.");
 
 	// Set language model
-	lambda_unique_ptr<ngram_model_t> languageModel(dialog
-		? createBiasedLanguageModel(*decoder, *dialog)
-		: createDefaultLanguageModel(*decoder));
+	lambda_unique_ptr<ngram_model_t> languageModel = [&] {
+		profiling::ScopedTimer lmTimer("LM build");
+		return dialogLanguageModel
+			? createBiasedLanguageModel(*decoder, *dialogLanguageModel)
+			: createDefaultLanguageModel(*decoder);
+	}();
+
+	// Set pronunciation dictionary
+	{
+		profiling::ScopedTimer dictionaryTimer("dictionary setup");
+		addDictionaryWords(*languageModel, *decoder);
+		if (dialogLanguageModel) {
+			addMissingDictionaryWords(dialogLanguageModel->getWords(), *decoder);
+		}
+	}
+
 	ps_set_lm(decoder.get(), "lm", languageModel.get());
 	ps_set_search(decoder.get(), "lm");
 
 	return decoder;
 }
 
+// Sets whether the acoustic model records codebook evaluations or reuses recorded ones.
+// Only PTM models support this; for other models, this does nothing.
+void setCodebookCacheMode(ps_decoder_t& decoder, ptm_topn_cache_mode_t mode) {
+	ptm_mgau_t* ptmModel = ptm_mgau_get(decoder.acmod->mgau);
+	if (ptmModel) {
+		ptm_mgau_set_topn_cache_mode(ptmModel, mode);
+	}
+}
+
+// Aligns the words with the utterance last processed by recognizeWords(). Reuses its features and,
+// if recorded, its codebook evaluations.
 optional<Timeline<Phone>> getPhoneAlignment(
 	const vector<s3wid_t>& wordIds,
-	const vector<int16_t>& audioBuffer,
 	ps_decoder_t& decoder)
 {
 	if (wordIds.empty()) return boost::none;
 
+	profiling::ScopedTimer timer("alignment");
+
 	// Create alignment list
 	lambda_unique_ptr<ps_alignment_t> alignment(
 		ps_alignment_init(decoder.d2p),
@@ -175,26 +295,21 @@ optional<Timeline<Phone>> getPhoneAlignment(
 		[](ps_search_t* search) { ps_search_free(search); });
 	if (!search) throw runtime_error("Error creating search.");
 
-	// Start recognition
-	error = acmod_start_utt(acousticModel);
-	if (error) throw runtime_error("Error starting utterance processing for alignment.");
+	// Go back to the first frame. The feature buffer still contains the entire utterance.
+	error = acmod_rewind(acousticModel);
+	if (error) throw runtime_error("Error rewinding utterance for alignment.");
 
 	{
-		// Eventually end recognition
-		auto endRecognition = gsl::finally([&]() { acmod_end_utt(acousticModel); });
+		setCodebookCacheMode(decoder, PTM_TOPN_CACHE_REPLAY);
+		auto stopReplay = gsl::finally([&]() { setCodebookCacheMode(decoder, PTM_TOPN_CACHE_OFF); });
 
 		// Start search
 		ps_search_start(search.get());
 
-		// Process entire audio clip
-		const int16* nextSample = audioBuffer.data();
-		size_t remainingSamples = audioBuffer.size();
-		const bool fullUtterance = true;
-		while (acmod_process_raw(acousticModel, &nextSample, &remainingSamples, fullUtterance) > 0) {
-			while (acousticModel->n_feat_frame > 0) {
-				ps_search_step(search.get(), acousticModel->output_frame);
-				acmod_advance(acousticModel);
-			}
+		// Process entire utterance
+		while (acousticModel->n_feat_frame > 0) {
+			ps_search_step(search.get(), acousticModel->output_frame);
+			acmod_advance(acousticModel);
 		}
 
 		// End search
@@ -248,7 +363,7 @@ string fixPronunciation(const string& word) {
 }
 
 static Timeline<Phone> utteranceToPhones(
-	const AudioClip& audioClip,
+	const MemoryAudioClip& audioClip,
 	TimeRange utteranceTimeRange,
 	ps_decoder_t& decoder,
 	ProgressSink& utteranceProgressSink
@@ -265,13 +380,13 @@ static Timeline<Phone> utteranceToPhones(
 	paddedTimeRange.grow(padding);
 	paddedTimeRange.trim(audioClip.getTruncatedRange());
 
-	const unique_ptr<AudioClip> clipSegment = audioClip.clone()
-		| segment(paddedTimeRange)
-		| resample(sphinxSampleRate);
-	const auto audioBuffer = copyTo16bitBuffer(*clipSegment);
+	const MemoryAudioClip clipSegment = audioClip.getSegment(paddedTimeRange);
+	const gsl::span<const int16_t> audioBuffer = clipSegment.getSamples();
 
-	// Get words
-	BoundedTimeline<string> words = recognizeWords(audioBuffer, decoder);
+	// Get words, recording codebook evaluations for alignment
+	setCodebookCacheMode(decoder, PTM_TOPN_CACHE_RECORD);
+	auto stopRecording = gsl::finally([&]() { setCodebookCacheMode(decoder, PTM_TOPN_CACHE_OFF); });
+	BoundedTimeline<string> words = recognizeWords(UtteranceCepstra(audioBuffer, decoder), decoder);
 	wordRecognitionProgressSink.reportProgress(1.0);
 
 	// Log utterance text
@@ -307,8 +422,8 @@ static Timeline<Phone> utteranceToPhones(
 #if BOOST_VERSION < 105600 // Support legacy syntax
 #define value_or get_value_or
 #endif
-	Timeline<Phone> utterancePhones = getPhoneAlignment(wordIds, audioBuffer, decoder)
-		.value_or(ContinuousTimeline<Phone>(clipSegment->getTruncatedRange(), Phone::Noise));
+	Timeline<Phone> utterancePhones = getPhoneAlignment(wordIds, decoder)
+		.value_or(ContinuousTimeline<Phone>(clipSegment.getTruncatedRange(), Phone::Noise));
 	alignmentProgressSink.reportProgress(1.0);
 	utterancePhones.shift(paddedTimeRange.getStart());
 
@@ -331,6 +446,21 @@ static Timeline<Phone> utteranceToPhones(
 	return utterancePhones;
 }
 
+// Returns a decoder factory that shares the dialog language model between all decoders it creates
+static decoderFactory createDecoderFactory(const optional<string>& dialog) {
+	const std::shared_ptr<DialogLanguageModel> dialogLanguageModel = dialog
+		? std::make_shared<DialogLanguageModel>(*dialog)
+		: nullptr;
+	return [dialogLanguageModel](const optional<string>&) {
+		return createDecoder(dialogLanguageModel.get());
+	};
+}
+
+PocketSphinxRecognizer::PocketSphinxRecognizer(centiseconds maxUtteranceLength) :
+	maxUtteranceLength(maxUtteranceLength),
+	decoderPool([] { return createDecoder(nullptr); })
+{}
+
 BoundedTimeline<Phone> PocketSphinxRecognizer::recognizePhones(
 	const AudioClip& inputAudioClip,
 	optional<std::string> dialog,
@@ -338,5 +468,23 @@ BoundedTimeline<Phone> PocketSphinxRecognizer::recognizePhones(
 	ProgressSink& progressSink
 ) const {
 	return ::recognizePhones(
-		inputAudioClip, dialog, &createDecoder, &utteranceToPhones, maxThreadCount, progressSink);
+		inputAudioClip,
+		dialog,
+		decoderPool,
+		createDecoderFactory(dialog),
+		&utteranceToPhones,
+		maxUtteranceLength,
+		maxThreadCount,
+		progressSink
+	);
+}
+
+unique_ptr<PhoneStream> PocketSphinxRecognizer::createPhoneStream(
+	int sampleRate,
+	optional<std::string> dialog,
+	centiseconds maxDelay
+) const {
+	return ::createPhoneStream(
+		sampleRate, dialog, maxDelay, createDecoderFactory(dialog), &utteranceToPhones
+	);
 }
@@ -5,10 +5,23 @@
 
 class PocketSphinxRecognizer : public Recognizer {
 public:
+	explicit PocketSphinxRecognizer(centiseconds maxUtteranceLength = defaultMaxUtteranceLength);
+
 	BoundedTimeline<Phone> recognizePhones(
 		const AudioClip& inputAudioClip,
 		boost::optional<std::string> dialog,
 		int maxThreadCount,
 		ProgressSink& progressSink
 	) const override;
+
+	std::unique_ptr<PhoneStream> createPhoneStream(
+		int sampleRate,
+		boost::optional<std::string> dialog,
+		centiseconds maxDelay
+	) const override;
+
+private:
+	centiseconds maxUtteranceLength;
+	// Decoders without dialog, kept for subsequent calls
+	mutable DecoderPool decoderPool;
 };
@@ -0,0 +1,269 @@
+#include "PronunciationDictionary.h"
+#include <format.h>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <unordered_map>
+#include "tools/fileTools.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::runtime_error;
+using std::filesystem::path;
+using boost::optional;
+
+// Increment whenever the binary format changes
+constexpr uint32_t formatVersion = 1;
+constexpr char formatMagic[8] = { 'R', 'H', 'B', 'D', 'I', 'C', 'T', '\0' };
+constexpr size_t maxPhoneNameLength = 7;
+
+// All numbers are stored in native byte order, since the file is created on the target platform.
+// Sections are 8-byte aligned.
+struct PronunciationDictionary::Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t phoneCount;
+	uint32_t entryCount;
+	// A power of two
+	uint32_t hashSlotCount;
+	uint32_t phoneNamesOffset;
+	uint32_t entriesOffset;
+	uint32_t hashSlotsOffset;
+	uint32_t wordsOffset;
+	uint32_t wordsSize;
+	uint32_t pronunciationsOffset;
+	uint32_t pronunciationsSize;
+	uint32_t reserved;
+};
+
+struct PronunciationDictionary::Entry {
+	// Relative to the words section
+	uint32_t wordOffset;
+	// Relative to the pronunciations section
+	uint32_t pronunciationOffset;
+	uint32_t baseEntryIndex;
+	uint16_t wordLength;
+	uint8_t pronunciationLength;
+	uint8_t reserved;
+};
+
+// FNV-1a
+uint32_t getWordHash(string_view word) {
+	uint32_t hash = 2166136261u;
+	for (char c : word) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Returns the word without alternative number. For "read(2)", that's "read".
+// Follows PocketSphinx's dict_word2basestr.
+string_view getBaseWord(string_view word) {
+	if (word.empty() || word.back() != ')') return word;
+
+	const size_t openingParenthesisIndex = word.rfind('(');
+	const bool isAlternative = openingParenthesisIndex != string_view::npos && openingParenthesisIndex > 0;
+	return isAlternative ? word.substr(0, openingParenthesisIndex) : word;
+}
+
+size_t alignSize(size_t size) {
+	return (size + 7) & ~static_cast<size_t>(7);
+}
+
+template<typename T>
+uint32_t appendSection(vector<char>& buffer, const T* data, size_t count) {
+	buffer.resize(alignSize(buffer.size()));
+	const size_t offset = buffer.size();
+	const char* bytes = reinterpret_cast<const char*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+	return static_cast<uint32_t>(offset);
+}
+
+void PronunciationDictionary::compile(const path& textFilePath, const path& binaryFilePath) {
+	vector<string> phoneNames;
+	std::unordered_map<string, uint8_t> phoneIndexesByName;
+	vector<Entry> entries;
+	std::unordered_map<string, uint32_t> entryIndexesByWord;
+	string words;
+	vector<uint8_t> pronunciations;
+
+	// Read text dictionary. Like PocketSphinx, skip invalid lines and duplicates.
+	std::ifstream textFile = openFile(textFilePath);
+	textFile.exceptions(std::ifstream::badbit);
+	string line;
+	while (std::getline(textFile, line)) {
+		if (line.compare(0, 2, "##") == 0 || line.compare(0, 2, ";;") == 0) continue;
+
+		std::istringstream lineStream(line);
+		string word;
+		vector<string> phones;
+		lineStream >> word;
+		for (string phone; lineStream >> phone;) {
+			phones.push_back(phone);
+		}
+		if (word.empty() || phones.empty()) continue;
+		if (entryIndexesByWord.count(word)) continue;
+
+		const string baseWord(getBaseWord(word));
+		const auto baseEntry = entryIndexesByWord.find(baseWord);
+		if (baseWord != word && baseEntry == entryIndexesByWord.end()) continue;
+
+		if (word.size() > UINT16_MAX || phones.size() > UINT8_MAX) {
+			throw runtime_error(fmt::format("Dictionary entry for '{}' is too long.", word));
+		}
+
+		const uint32_t entryIndex = static_cast<uint32_t>(entries.size());
+		Entry entry {};
+		entry.wordOffset = static_cast<uint32_t>(words.size());
+		entry.wordLength = static_cast<uint16_t>(word.size());
+		entry.pronunciationOffset = static_cast<uint32_t>(pronunciations.size());
+		entry.pronunciationLength = static_cast<uint8_t>(phones.size());
+		entry.baseEntryIndex = baseWord == word ? entryIndex : baseEntry->second;
+		entries.push_back(entry);
+		entryIndexesByWord[word] = entryIndex;
+		words += word;
+
+		for (const string& phone : phones) {
+			auto it = phoneIndexesByName.find(phone);
+			if (it == phoneIndexesByName.end()) {
+				if (phoneNames.size() > UINT8_MAX || phone.size() > maxPhoneNameLength) {
+					throw runtime_error(fmt::format("Unsupported phone '{}'.", phone));
+				}
+				it = phoneIndexesByName.emplace(phone, static_cast<uint8_t>(phoneNames.size())).first;
+				phoneNames.push_back(phone);
+			}
+			pronunciations.push_back(it->second);
+		}
+	}
+
+	// Create hash table with a load factor of at most 0.5, using linear probing.
+	// Slots contain entry index + 1, so that 0 means empty.
+	uint32_t hashSlotCount = 1;
+	while (hashSlotCount < entries.size() * 2) hashSlotCount *= 2;
+	vector<uint32_t> hashSlots(hashSlotCount, 0);
+	for (uint32_t entryIndex = 0; entryIndex < entries.size(); ++entryIndex) {
+		const Entry& entry = entries[entryIndex];
+		const string_view word(words.data() + entry.wordOffset, entry.wordLength);
+		uint32_t slotIndex = getWordHash(word) & (hashSlotCount - 1);
+		while (hashSlots[slotIndex] != 0) {
+			slotIndex = (slotIndex + 1) & (hashSlotCount - 1);
+		}
+		hashSlots[slotIndex] = entryIndex + 1;
+	}
+
+	// Lay out file
+	vector<char> phoneNameData(phoneNames.size() * (maxPhoneNameLength + 1), '\0');
+	for (size_t i = 0; i < phoneNames.size(); ++i) {
+		std::copy(phoneNames[i].begin(), phoneNames[i].end(), &phoneNameData[i * (maxPhoneNameLength + 1)]);
+	}
+	Header header {};
+	std::copy(std::begin(formatMagic), std::end(formatMagic), header.magic);
+	header.version = formatVersion;
+	header.phoneCount = static_cast<uint32_t>(phoneNames.size());
+	header.entryCount = static_cast<uint32_t>(entries.size());
+	header.hashSlotCount = hashSlotCount;
+	vector<char> buffer(sizeof(Header));
+	header.phoneNamesOffset = appendSection(buffer, phoneNameData.data(), phoneNameData.size());
+	header.entriesOffset = appendSection(buffer, entries.data(), entries.size());
+	header.hashSlotsOffset = appendSection(buffer, hashSlots.data(), hashSlots.size());
+	header.wordsOffset = appendSection(buffer, words.data(), words.size());
+	header.wordsSize = static_cast<uint32_t>(words.size());
+	header.pronunciationsOffset = appendSection(buffer, pronunciations.data(), pronunciations.size());
+	header.pronunciationsSize = static_cast<uint32_t>(pronunciations.size());
+	std::memcpy(buffer.data(), &header, sizeof(Header));
+
+	// Write file
+	std::ofstream binaryFile;
+	binaryFile.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+	binaryFile.open(binaryFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	binaryFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+PronunciationDictionary::PronunciationDictionary(const path& filePath) :
+	file(filePath)
+{
+	const auto isInFile = [&](size_t offset, size_t size) {
+		return offset <= file.size() && size <= file.size() - offset;
+	};
+	if (!isInFile(0, sizeof(Header))
+		|| std::memcmp(file.data(), formatMagic, sizeof formatMagic) != 0
+	) {
+		throw runtime_error(fmt::format(
+			"{} is not a pronunciation dictionary.",
+			filePath.u8string()
+		));
+	}
+
+	header = reinterpret_cast<const Header*>(file.data());
+	if (header->version != formatVersion) {
+		throw runtime_error(fmt::format(
+			"Pronunciation dictionary {} has version {}, expected {}.",
+			filePath.u8string(), header->version, formatVersion
+		));
+	}
+
+	const bool isValid = isInFile(header->phoneNamesOffset, header->phoneCount * (maxPhoneNameLength + 1))
+		&& isInFile(header->entriesOffset, header->entryCount * sizeof(Entry))
+		&& isInFile(header->hashSlotsOffset, header->hashSlotCount * sizeof(uint32_t))
+		&& isInFile(header->wordsOffset, header->wordsSize)
+		&& isInFile(header->pronunciationsOffset, header->pronunciationsSize)
+		&& header->hashSlotCount > header->entryCount
+		&& (header->hashSlotCount & (header->hashSlotCount - 1)) == 0;
+	if (!isValid) {
+		throw runtime_error(fmt::format("Pronunciation dictionary {} is corrupt.", filePath.u8string()));
+	}
+
+	for (uint32_t i = 0; i < header->phoneCount; ++i) {
+		phoneNames.emplace_back(file.data() + header->phoneNamesOffset + i * (maxPhoneNameLength + 1));
+	}
+	entries = reinterpret_cast<const Entry*>(file.data() + header->entriesOffset);
+	hashSlots = reinterpret_cast<const uint32_t*>(file.data() + header->hashSlotsOffset);
+	words = file.data() + header->wordsOffset;
+	pronunciations = reinterpret_cast<const uint8_t*>(file.data() + header->pronunciationsOffset);
+}
+
+int PronunciationDictionary::getEntryCount() const {
+	return static_cast<int>(header->entryCount);
+}
+
+optional<int> PronunciationDictionary::find(const string& word) const {
+	const uint32_t slotMask = header->hashSlotCount - 1;
+	for (uint32_t slotIndex = getWordHash(word) & slotMask;; slotIndex = (slotIndex + 1) & slotMask) {
+		const uint32_t slot = hashSlots[slotIndex];
+		if (slot == 0) return boost::none;
+
+		const int entryIndex = static_cast<int>(slot - 1);
+		if (getWord(entryIndex) == word) return entryIndex;
+	}
+}
+
+bool PronunciationDictionary::contains(const string& word) const {
+	return find(word).is_initialized();
+}
+
+string_view PronunciationDictionary::getWord(int entryIndex) const {
+	const Entry& entry = getEntry(entryIndex);
+	return string_view(words + entry.wordOffset, entry.wordLength);
+}
+
+int PronunciationDictionary::getBaseEntryIndex(int entryIndex) const {
+	return static_cast<int>(getEntry(entryIndex).baseEntryIndex);
+}
+
+gsl::span<const uint8_t> PronunciationDictionary::getPronunciation(int entryIndex) const {
+	const Entry& entry = getEntry(entryIndex);
+	return gsl::span<const uint8_t>(pronunciations + entry.pronunciationOffset, entry.pronunciationLength);
+}
+
+const vector<string>& PronunciationDictionary::getPhoneNames() const {
+	return phoneNames;
+}
+
+const PronunciationDictionary::Entry& PronunciationDictionary::getEntry(int entryIndex) const {
+	if (entryIndex < 0 || entryIndex >= getEntryCount()) {
+		throw std::out_of_range(fmt::format("Invalid dictionary entry index {}.", entryIndex));
+	}
+	return entries[entryIndex];
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <boost/optional.hpp>
+#include <span.h>
+#include "tools/MemoryMappedFile.h"
+
+// A read-only pronunciation dictionary in a compact binary format.
+// The file is memory-mapped and used in place, so loading is nearly instant.
+// All methods can be called concurrently from multiple threads.
+class PronunciationDictionary {
+public:
+	explicit PronunciationDictionary(const std::filesystem::path& filePath);
+
+	// Converts a dictionary in CMU Sphinx text format to the binary format
+	static void compile(
+		const std::filesystem::path& textFilePath,
+		const std::filesystem::path& binaryFilePath
+	);
+
+	// Returns the number of entries. Each alternative pronunciation of a word, such as "read(2)",
+	// is an entry of its own.
+	int getEntryCount() const;
+
+	// Returns the index of the entry with the specified word, if any
+	boost::optional<int> find(const std::string& word) const;
+
+	bool contains(const std::string& word) const;
+
+	std::string_view getWord(int entryIndex) const;
+
+	// Returns the index of the entry without alternative number. For "read(2)", that's "read".
+	int getBaseEntryIndex(int entryIndex) const;
+
+	// Returns the pronunciation as indexes into getPhoneNames()
+	gsl::span<const uint8_t> getPronunciation(int entryIndex) const;
+
+	const std::vector<std::string>& getPhoneNames() const;
+
+private:
+	struct Header;
+	struct Entry;
+
+	const Entry& getEntry(int entryIndex) const;
+
+	MemoryMappedFile file;
+	const Header* header = nullptr;
+	const Entry* entries = nullptr;
+	const uint32_t* hashSlots = nullptr;
+	const char* words = nullptr;
+	const uint8_t* pronunciations = nullptr;
+	std::vector<std::string> phoneNames;
+};
@@ -5,6 +5,21 @@
 #include "tools/progress.h"
 #include "time/BoundedTimeline.h"
 
+// Recognizes phones in audio that arrives incrementally
+class PhoneStream {
+public:
+	virtual ~PhoneStream() = default;
+
+	// Processes the specified samples. Returns the phones of all utterances that have ended.
+	virtual Timeline<Phone> write(gsl::span<const float> samples) = 0;
+
+	// Ends the stream. Returns the phones of the remaining utterance, if any.
+	virtual Timeline<Phone> close() = 0;
+
+	// Returns the time before which all phones have been returned
+	virtual centiseconds getCompletedTime() const = 0;
+};
+
 class Recognizer {
 public:
 	virtual ~Recognizer() = default;
@@ -15,4 +30,12 @@ public:
 		int maxThreadCount,
 		ProgressSink& progressSink
 	) const = 0;
-};
\ No newline at end of file
+
+	// Creates a stream for audio with the specified sample rate.
+	// The completed time of the stream lags behind the audio by no more than maxDelay.
+	virtual std::unique_ptr<PhoneStream> createPhoneStream(
+		int sampleRate,
+		boost::optional<std::string> dialog,
+		centiseconds maxDelay
+	) const = 0;
+};
@@ -1,24 +1,256 @@
 #include <g2p.h>
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include "tools/stringTools.h"
 #include "logging/logging.h"
 
 using std::vector;
 using std::wstring;
-using std::regex;
-using std::wregex;
+using std::array;
+using std::bitset;
 using std::invalid_argument;
 using std::pair;
 
-const vector<pair<wregex, wstring>>& getReplacementRules() {
-	static vector<pair<wregex, wstring>> rules {
-		#include "g2pRules.cpp"
+bool isInSet(wchar_t c, const bitset<256>& set) {
+	return static_cast<size_t>(c) < set.size() && set[c];
+}
+
+// A replacement rule using the regex subset that g2pRules.rb generates:
+// literals, character classes, exact repetition, optional atoms, capture groups, and anchors.
+// Replacing is equivalent to std::regex_replace in ECMAScript mode, but much faster.
+class ReplacementRule {
+public:
+	ReplacementRule(const wstring& pattern, const wstring& replacement);
+
+	// Replaces all non-overlapping matches in the input, writing the result to output.
+	// Returns false if there was no match.
+	bool apply(const wstring& input, wstring& output) const;
+
+private:
+	struct Element {
+		enum class Type { Characters, Begin, End, GroupBegin, GroupEnd };
+
+		Type type = Type::Characters;
+		bitset<256> characters;
+		bool optional = false;
+		int group = 0;
+	};
 
-		// Turn bigrams into unigrams for easier conversion
-		{ wregex(L"ôw"), L"Ω" },
-		{ wregex(L"öy"), L"ω" },
-		{ wregex(L"@r"), L"ɝ" }
+	struct ReplacementPart {
+		// The capture group to insert, or 0 for literal text
+		int group;
+		wstring text;
 	};
+
+	using Captures = array<pair<size_t, size_t>, 10>;
+
+	bool match(
+		const wstring& input,
+		size_t elementIndex,
+		size_t position,
+		Captures& captures
+	) const;
+
+	vector<Element> elements;
+	// The characters a match can start with
+	bitset<256> firstCharacters;
+	vector<ReplacementPart> replacementParts;
+};
+
+ReplacementRule::ReplacementRule(const wstring& pattern, const wstring& replacement) {
+	const auto fail = [](const char* reason) {
+		return invalid_argument(fmt::format("Invalid G2P rule: {}.", reason));
+	};
+
+	// Parse pattern
+	vector<int> openGroups;
+	int groupCount = 0;
+	bool hasRequiredCharacter = false;
+	for (size_t i = 0; i < pattern.size(); ++i) {
+		const wchar_t c = pattern[i];
+		const bool isOptionalAtom = pattern.compare(i, 3, L"(?:") == 0;
+		if (isOptionalAtom) {
+			i += 3;
+		}
+
+		Element element;
+		if (c == L'^' || c == L'$') {
+			element.type = c == L'^' ? Element::Type::Begin : Element::Type::End;
+		} else if (c == L'(' && !isOptionalAtom) {
+			element.type = Element::Type::GroupBegin;
+			element.group = ++groupCount;
+			openGroups.push_back(element.group);
+			if (groupCount >= static_cast<int>(Captures().size())) throw fail("too many groups");
+		} else if (c == L')') {
+			if (openGroups.empty()) throw fail("unbalanced parentheses");
+			element.type = Element::Type::GroupEnd;
+			element.group = openGroups.back();
+			openGroups.pop_back();
+		} else if (c == L'{') {
+			const size_t endIndex = pattern.find(L'}', i);
+			if (elements.empty() || elements.back().type != Element::Type::Characters || endIndex == wstring::npos) {
+				throw fail("invalid repetition");
+			}
+			const int count = std::stoi(pattern.substr(i + 1, endIndex - i - 1));
+			for (int j = 1; j < count; ++j) {
+				elements.push_back(elements.back());
+			}
+			i = endIndex;
+			continue;
+		} else {
+			if (i >= pattern.size()) throw fail("unexpected end");
+			wstring characters;
+			if (pattern[i] == L'[') {
+				const size_t endIndex = pattern.find(L']', i);
+				if (endIndex == wstring::npos) throw fail("unterminated character class");
+				characters = pattern.substr(i + 1, endIndex - i - 1);
+				i = endIndex;
+			} else if (pattern[i] == L'\\' && i + 1 < pattern.size()) {
+				characters = pattern[++i];
+			} else if (wstring(L"()[]{}?*+|.^$\\").find(pattern[i]) == wstring::npos) {
+				characters = pattern[i];
+			} else {
+				throw fail("unsupported syntax");
+			}
+			for (wchar_t character : characters) {
+				if (static_cast<size_t>(character) >= element.characters.size()) {
+					throw fail("unsupported character");
+				}
+				element.characters.set(character);
+			}
+
+			if (isOptionalAtom) {
+				if (pattern.compare(i + 1, 2, L")?") != 0) throw fail("unsupported optional group");
+				element.optional = true;
+				i += 2;
+			} else {
+				hasRequiredCharacter = true;
+			}
+		}
+		elements.push_back(element);
+	}
+	if (!openGroups.empty()) throw fail("unbalanced parentheses");
+	if (!hasRequiredCharacter) throw fail("pattern may match empty string");
+
+	for (const Element& element : elements) {
+		if (element.type != Element::Type::Characters) continue;
+
+		firstCharacters |= element.characters;
+		if (!element.optional) break;
+	}
+
+	// Parse replacement
+	for (size_t i = 0; i < replacement.size(); ++i) {
+		const wchar_t c = replacement[i];
+		const bool isGroupReference = c == L'$'
+			&& i + 1 < replacement.size()
+			&& replacement[i + 1] >= L'1' && replacement[i + 1] <= L'9';
+		if (isGroupReference) {
+			const int group = replacement[++i] - L'0';
+			if (group > groupCount) throw fail("invalid group reference");
+			replacementParts.push_back({ group, wstring() });
+			continue;
+		}
+
+		if (c == L'$' && i + 1 < replacement.size() && replacement[i + 1] == L'$') {
+			++i;
+		}
+		if (replacementParts.empty() || replacementParts.back().group != 0) {
+			replacementParts.push_back({ 0, wstring() });
+		}
+		replacementParts.back().text += c;
+	}
+}
+
+bool ReplacementRule::match(
+	const wstring& input,
+	size_t elementIndex,
+	size_t position,
+	Captures& captures
+) const {
+	if (elementIndex == elements.size()) {
+		captures[0].second = position;
+		return true;
+	}
+
+	const Element& element = elements[elementIndex];
+	switch (element.type) {
+		case Element::Type::Characters: {
+			if (position < input.size() && isInSet(input[position], element.characters)
+				&& match(input, elementIndex + 1, position + 1, captures)
+			) {
+				return true;
+			}
+			// Optional atoms are greedy, so we only skip them after trying to match them
+			return element.optional && match(input, elementIndex + 1, position, captures);
+		}
+		case Element::Type::Begin:
+			// Consecutive matches don't restart the input, so this only matches at its start
+			return position == 0 && match(input, elementIndex + 1, position, captures);
+		case Element::Type::End:
+			return position == input.size() && match(input, elementIndex + 1, position, captures);
+		case Element::Type::GroupBegin:
+			captures[element.group].first = position;
+			return match(input, elementIndex + 1, position, captures);
+		case Element::Type::GroupEnd:
+			captures[element.group].second = position;
+			return match(input, elementIndex + 1, position, captures);
+		default:
+			throw std::logic_error("Unexpected element type.");
+	}
+}
+
+bool ReplacementRule::apply(const wstring& input, wstring& output) const {
+	output.clear();
+	bool matched = false;
+	size_t position = 0;
+	Captures captures;
+	for (size_t start = 0; start < input.size(); ++start) {
+		if (!isInSet(input[start], firstCharacters)) continue;
+
+		captures[0].first = start;
+		if (!match(input, 0, start, captures)) continue;
+
+		matched = true;
+		output.append(input, position, start - position);
+		for (const ReplacementPart& part : replacementParts) {
+			if (part.group == 0) {
+				output += part.text;
+			} else {
+				const auto& capture = captures[part.group];
+				output.append(input, capture.first, capture.second - capture.first);
+			}
+		}
+		position = captures[0].second;
+		// The pattern can't match the empty string, so the next match starts after this one
+		start = position - 1;
+	}
+	output.append(input, position, wstring::npos);
+	return matched;
+}
+
+const vector<ReplacementRule>& getReplacementRules() {
+	static const vector<ReplacementRule> rules = [] {
+		const vector<pair<wstring, wstring>> ruleDefinitions {
+			#include "g2pRules.cpp"
+
+			// Turn bigrams into unigrams for easier conversion
+			{ L"ôw", L"Ω" },
+			{ L"öy", L"ω" },
+			{ L"@r", L"ɝ" }
+		};
+		vector<ReplacementRule> result;
+		result.reserve(ruleDefinitions.size());
+		for (size_t i = 0; i < ruleDefinitions.size(); ++i) {
+			try {
+				result.emplace_back(ruleDefinitions[i].first, ruleDefinitions[i].second);
+			} catch (...) {
+				std::throw_with_nested(std::runtime_error(fmt::format("Error compiling G2P rule #{}.", i)));
+			}
+		}
+		return result;
+	}();
 	return rules;
 }
 
@@ -70,23 +302,20 @@ Phone charToPhone(wchar_t c) {
 }
 
 vector<Phone> wordToPhones(const std::string& word) {
-	static regex validWord("^[a-z']*$");
-	if (!regex_match(word, validWord)) {
+	const bool isValidWord = std::all_of(word.begin(), word.end(), [](char c) {
+		return (c >= 'a' && c <= 'z') || c == '\'';
+	});
+	if (!isValidWord) {
 		throw invalid_argument(fmt::format("Word '{}' contains illegal characters.", word));
 	}
 
 	wstring wideWord = latin1ToWide(word);
+	wstring buffer;
 	for (const auto& rule : getReplacementRules()) {
-		const wregex& regex = rule.first;
-		const wstring& replacement = rule.second;
-
 		// Repeatedly apply rule until there is no more change
-		bool changed;
-		do {
-			wstring tmp = regex_replace(wideWord, regex, replacement);
-			changed = tmp != wideWord;
-			wideWord = tmp;
-		} while (changed);
+		while (rule.apply(wideWord, buffer) && buffer != wideWord) {
+			wideWord.swap(buffer);
+		}
 	}
 
 	// Remove duplicate phones
@@ -63,7 +63,7 @@ def formatRule(searchValue, replaceValue, contextBegin, contextEnd)
   regexString.gsub!(/[\\"]/, '\\\\\\\\')
   replaceValue.gsub!(/[\\"]/, '\\\\\\\\')
   
-  return "{ wregex(L\"#{regexString}\"), L\"#{replaceValue}\" },"
+  return "{ L\"#{regexString}\", L\"#{replaceValue}\" },"
 end
 
 # Read rules
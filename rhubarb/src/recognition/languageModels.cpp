@@ -1,201 +1,218 @@
 #include "languageModels.h"
-#include <boost/range/adaptor/map.hpp>
 #include <vector>
-#include <regex>
-#include <map>
-#include <tuple>
-#include "tools/platformTools.h"
-#include <fstream>
-#include "core/appInfo.h"
+#include <unordered_map>
+#include <algorithm>
 #include <cmath>
+#include <format.h>
 #include <gsl_util.h>
 
+extern "C" {
+#include <libsphinxbase/lm/ngram_model_trie.h>
+}
+
 using std::string;
 using std::vector;
-using std::regex;
-using std::map;
-using std::tuple;
-using std::get;
-using std::endl;
-using std::filesystem::path;
-
-using Unigram = string;
-using Bigram = tuple<string, string>;
-using Trigram = tuple<string, string, string>;
-
-map<Unigram, int> getUnigramCounts(const vector<string>& words) {
-	map<Unigram, int> unigramCounts;
-	for (const Unigram& unigram : words) {
-		++unigramCounts[unigram];
-	}
-	return unigramCounts;
+using std::unordered_map;
+using std::array;
+using std::invalid_argument;
+
+// N-grams are counted by word IDs packed into a single integer. Word IDs are assigned in
+// alphabetical order, so ordering keys numerically orders n-grams by their words.
+using NGramKey = uint64_t;
+constexpr int wordIdBits = 21;
+constexpr int maxVocabularySize = 1 << wordIdBits;
+
+NGramKey getNGramKey(int first, int second) {
+	return (static_cast<NGramKey>(first) << wordIdBits) | static_cast<NGramKey>(second);
 }
 
-map<Bigram, int> getBigramCounts(const vector<string>& words) {
-	map<Bigram, int> bigramCounts;
-	for (auto it = words.begin(); it < words.end() - 1; ++it) {
-		++bigramCounts[Bigram(*it, *(it + 1))];
-	}
-	return bigramCounts;
+NGramKey getNGramKey(int first, int second, int third) {
+	return (getNGramKey(first, second) << wordIdBits) | static_cast<NGramKey>(third);
 }
 
-map<Trigram, int> getTrigramCounts(const vector<string>& words) {
-	map<Trigram, int> trigramCounts;
-	if (words.size() >= 3) {
-		for (auto it = words.begin(); it < words.end() - 2; ++it) {
-			++trigramCounts[Trigram(*it, *(it + 1), *(it + 2))];
-		}
-	}
-	return trigramCounts;
+int getNGramWordId(NGramKey key, int index, int order) {
+	return static_cast<int>((key >> (wordIdBits * (order - 1 - index))) & (maxVocabularySize - 1));
 }
 
-map<Unigram, double> getUnigramProbabilities(
-	const vector<string>& words,
-	const map<Unigram, int>& unigramCounts,
-	const double deflator
-) {
-	map<Unigram, double> unigramProbabilities;
-	for (const auto& pair : unigramCounts) {
-		const Unigram& unigram = get<0>(pair);
-		const int unigramCount = get<1>(pair);
-		unigramProbabilities[unigram] = double(unigramCount) / words.size() * deflator;
+struct NGramCount {
+	NGramKey key;
+	int count;
+};
+
+// Returns the counts of all n-grams, ordered by key
+vector<NGramCount> getSortedCounts(const unordered_map<NGramKey, int>& counts) {
+	vector<NGramCount> result;
+	result.reserve(counts.size());
+	for (const auto& pair : counts) {
+		result.push_back({ pair.first, pair.second });
 	}
-	return unigramProbabilities;
+	std::sort(result.begin(), result.end(), [](const NGramCount& a, const NGramCount& b) {
+		return a.key < b.key;
+	});
+	return result;
 }
 
-map<Bigram, double> getBigramProbabilities(
-	const map<Unigram, int>& unigramCounts,
-	const map<Bigram, int>& bigramCounts,
-	const double deflator
-) {
-	map<Bigram, double> bigramProbabilities;
-	for (const auto& pair : bigramCounts) {
-		Bigram bigram = get<0>(pair);
-		const int bigramCount = get<1>(pair);
-		const int unigramPrefixCount = unigramCounts.at(get<0>(bigram));
-		bigramProbabilities[bigram] = double(bigramCount) / unigramPrefixCount * deflator;
-	}
-	return bigramProbabilities;
-}
+NGramLanguageModel estimateLanguageModel(const vector<string>& words) {
+	const double discountMass = 0.5;
+	const double deflator = 1.0 - discountMass;
 
-map<Trigram, double> getTrigramProbabilities(
-	const map<Bigram, int>& bigramCounts,
-	const map<Trigram, int>& trigramCounts,
-	const double deflator
-) {
-	map<Trigram, double> trigramProbabilities;
-	for (const auto& pair : trigramCounts) {
-		Trigram trigram = get<0>(pair);
-		const int trigramCount = get<1>(pair);
-		const int bigramPrefixCount = bigramCounts.at(Bigram(get<0>(trigram), get<1>(trigram)));
-		trigramProbabilities[trigram] = double(trigramCount) / bigramPrefixCount * deflator;
-	}
-	return trigramProbabilities;
-}
+	NGramLanguageModel result;
 
-map<Unigram, double> getUnigramBackoffWeights(
-	const map<Unigram, int>& unigramCounts,
-	const map<Unigram, double>& unigramProbabilities,
-	const map<Bigram, int>& bigramCounts,
-	const double discountMass)
-{
-	map<Unigram, double> unigramBackoffWeights;
-	for (const Unigram& unigram : unigramCounts | boost::adaptors::map_keys) {
-		double denominator = 1;
-		for (const Bigram& bigram : bigramCounts | boost::adaptors::map_keys) {
-			if (get<0>(bigram) == unigram) {
-				denominator -= unigramProbabilities.at(get<1>(bigram));
-			}
-		}
-		unigramBackoffWeights[unigram] = discountMass / denominator;
+	// Assign word IDs in alphabetical order
+	result.words = words;
+	std::sort(result.words.begin(), result.words.end());
+	result.words.erase(std::unique(result.words.begin(), result.words.end()), result.words.end());
+	const int vocabularySize = static_cast<int>(result.words.size());
+	if (vocabularySize > maxVocabularySize) {
+		throw invalid_argument(fmt::format("Vocabulary too large: {} words.", vocabularySize));
+	}
+	unordered_map<string, int> wordIdsByWord;
+	for (int wordId = 0; wordId < vocabularySize; ++wordId) {
+		wordIdsByWord.emplace(result.words[wordId], wordId);
+	}
+	vector<int> wordIds;
+	wordIds.reserve(words.size());
+	for (const string& word : words) {
+		wordIds.push_back(wordIdsByWord.at(word));
 	}
-	return unigramBackoffWeights;
-}
 
-map<Bigram, double> getBigramBackoffWeights(
-	const map<Bigram, int>& bigramCounts,
-	const map<Bigram, double>& bigramProbabilities,
-	const map<Trigram, int>& trigramCounts,
-	const double discountMass)
-{
-	map<Bigram, double> bigramBackoffWeights;
-	for (const Bigram& bigram : bigramCounts | boost::adaptors::map_keys) {
-		double denominator = 1;
-		for (const Trigram& trigram : trigramCounts | boost::adaptors::map_keys) {
-			if (Bigram(get<0>(trigram), get<1>(trigram)) == bigram) {
-				denominator -= bigramProbabilities.at(Bigram(get<1>(trigram), get<2>(trigram)));
-			}
+	// Count n-grams
+	vector<int> unigramCounts(vocabularySize, 0);
+	unordered_map<NGramKey, int> bigramCountsByKey;
+	unordered_map<NGramKey, int> trigramCountsByKey;
+	for (size_t i = 0; i < wordIds.size(); ++i) {
+		++unigramCounts[wordIds[i]];
+		if (i + 1 < wordIds.size()) {
+			++bigramCountsByKey[getNGramKey(wordIds[i], wordIds[i + 1])];
+		}
+		if (i + 2 < wordIds.size()) {
+			++trigramCountsByKey[getNGramKey(wordIds[i], wordIds[i + 1], wordIds[i + 2])];
 		}
-		bigramBackoffWeights[bigram] = discountMass / denominator;
 	}
-	return bigramBackoffWeights;
-}
+	const vector<NGramCount> bigramCounts = getSortedCounts(bigramCountsByKey);
+	const vector<NGramCount> trigramCounts = getSortedCounts(trigramCountsByKey);
 
-void createLanguageModelFile(const vector<string>& words, const path& filePath) {
-	const double discountMass = 0.5;
-	const double deflator = 1.0 - discountMass;
-
-	map<Unigram, int> unigramCounts = getUnigramCounts(words);
-	map<Bigram, int> bigramCounts = getBigramCounts(words);
-	map<Trigram, int> trigramCounts = getTrigramCounts(words);
-
-	map<Unigram, double> unigramProbabilities =
-		getUnigramProbabilities(words, unigramCounts, deflator);
-	map<Bigram, double> bigramProbabilities =
-		getBigramProbabilities(unigramCounts, bigramCounts, deflator);
-	map<Trigram, double> trigramProbabilities =
-		getTrigramProbabilities(bigramCounts, trigramCounts, deflator);
-
-	map<Unigram, double> unigramBackoffWeights =
-		getUnigramBackoffWeights(unigramCounts, unigramProbabilities, bigramCounts, discountMass);
-	map<Bigram, double> bigramBackoffWeights =
-		getBigramBackoffWeights(bigramCounts, bigramProbabilities, trigramCounts, discountMass);
-
-	std::ofstream file(filePath);
-	file << "Generated by " << appName << " " << appVersion << endl << endl;
-
-	file << "\\data\\" << endl;
-	file << "ngram 1=" << unigramCounts.size() << endl;
-	file << "ngram 2=" << bigramCounts.size() << endl;
-	file << "ngram 3=" << trigramCounts.size() << endl << endl;
-
-	file.setf(std::ios::fixed, std::ios::floatfield);
-	file.precision(4);
-	file << "\\1-grams:" << endl;
-	for (const Unigram& unigram : unigramCounts | boost::adaptors::map_keys) {
-		file << log10(unigramProbabilities.at(unigram))
-			<< " " << unigram
-			<< " " << log10(unigramBackoffWeights.at(unigram)) << endl;
+	// Calculate probabilities
+	vector<double> unigramProbabilities(vocabularySize);
+	for (int wordId = 0; wordId < vocabularySize; ++wordId) {
+		unigramProbabilities[wordId] = double(unigramCounts[wordId]) / words.size() * deflator;
+	}
+	vector<double> bigramProbabilities(bigramCounts.size());
+	unordered_map<NGramKey, size_t> bigramIndexes;
+	for (size_t i = 0; i < bigramCounts.size(); ++i) {
+		const int unigramPrefixCount = unigramCounts[getNGramWordId(bigramCounts[i].key, 0, 2)];
+		bigramProbabilities[i] = double(bigramCounts[i].count) / unigramPrefixCount * deflator;
+		bigramIndexes.emplace(bigramCounts[i].key, i);
+	}
+	vector<double> trigramProbabilities(trigramCounts.size());
+	for (size_t i = 0; i < trigramCounts.size(); ++i) {
+		const int bigramPrefixCount = bigramCountsByKey.at(trigramCounts[i].key >> wordIdBits);
+		trigramProbabilities[i] = double(trigramCounts[i].count) / bigramPrefixCount * deflator;
 	}
-	file << endl;
 
-	file << "\\2-grams:" << endl;
-	for (const Bigram& bigram : bigramCounts | boost::adaptors::map_keys) {
-		file << log10(bigramProbabilities.at(bigram))
-			<< " " << get<0>(bigram) << " " << get<1>(bigram)
-			<< " " << log10(bigramBackoffWeights.at(bigram)) << endl;
+	// Calculate backoff weights. Each n-gram's denominator is reduced by the lower-order
+	// probabilities of all its continuations, which form a contiguous run in key order.
+	vector<double> unigramDenominators(vocabularySize, 1.0);
+	for (const NGramCount& bigram : bigramCounts) {
+		unigramDenominators[getNGramWordId(bigram.key, 0, 2)] -=
+			unigramProbabilities[getNGramWordId(bigram.key, 1, 2)];
+	}
+	vector<double> bigramDenominators(bigramCounts.size(), 1.0);
+	for (const NGramCount& trigram : trigramCounts) {
+		const size_t prefixIndex = bigramIndexes.at(trigram.key >> wordIdBits);
+		const size_t suffixIndex = bigramIndexes.at(trigram.key & ((NGramKey(1) << (2 * wordIdBits)) - 1));
+		bigramDenominators[prefixIndex] -= bigramProbabilities[suffixIndex];
 	}
-	file << endl;
 
-	file << "\\3-grams:" << endl;
-	for (const Trigram& trigram : trigramCounts | boost::adaptors::map_keys) {
-		file << log10(trigramProbabilities.at(trigram))
-			<< " " << get<0>(trigram) << " " << get<1>(trigram) << " " << get<2>(trigram) << endl;
+	for (int wordId = 0; wordId < vocabularySize; ++wordId) {
+		result.ngrams[0].push_back({
+			{ wordId, 0, 0 },
+			log10(unigramProbabilities[wordId]),
+			log10(discountMass / unigramDenominators[wordId])
+		});
+	}
+	for (size_t i = 0; i < bigramCounts.size(); ++i) {
+		const NGramKey key = bigramCounts[i].key;
+		result.ngrams[1].push_back({
+			{ getNGramWordId(key, 0, 2), getNGramWordId(key, 1, 2), 0 },
+			log10(bigramProbabilities[i]),
+			log10(discountMass / bigramDenominators[i])
+		});
+	}
+	for (size_t i = 0; i < trigramCounts.size(); ++i) {
+		const NGramKey key = trigramCounts[i].key;
+		result.ngrams[2].push_back({
+			{ getNGramWordId(key, 0, 3), getNGramWordId(key, 1, 3), getNGramWordId(key, 2, 3) },
+			log10(trigramProbabilities[i]),
+			0.0
+		});
 	}
-	file << endl;
+	return result;
+}
 
-	file << "\\end\\" << endl;
+// Rounds a log10 value the way it used to be written to ARPA files, with four decimals.
+// Recognition results depend on the exact model weights, so they must not gain precision.
+double toArpaPrecision(double log10Value) {
+	return std::round(log10Value * 10000.0) / 10000.0;
 }
 
 lambda_unique_ptr<ngram_model_t> createLanguageModel(
-	const vector<string>& words,
+	const NGramLanguageModel& languageModel,
 	ps_decoder_t& decoder
 ) {
-	path tempFilePath = getTempFilePath();
-	createLanguageModelFile(words, tempFilePath);
-	auto deleteTempFile = gsl::finally([&]() { std::filesystem::remove(tempFilePath); });
-
-	return lambda_unique_ptr<ngram_model_t>(
-		ngram_model_read(decoder.config, tempFilePath.u8string().c_str(), NGRAM_ARPA, decoder.lmath),
+	// Fill in the same structures sphinxbase creates when reading an ARPA file
+	constexpr int order = 3;
+	array<uint32, order> counts;
+	for (int i = 0; i < order; ++i) {
+		counts[i] = static_cast<uint32>(languageModel.ngrams[i].size());
+	}
+	logmath_t& lmath = *decoder.lmath;
+	lambda_unique_ptr<ngram_model_t> result(
+		ngram_model_trie_init(&lmath, counts.data(), order),
 		[](ngram_model_t* lm) { ngram_model_free(lm); });
+	lm_trie_t& trie = *reinterpret_cast<ngram_model_trie_t*>(result.get())->trie;
+
+	for (size_t wordId = 0; wordId < languageModel.words.size(); ++wordId) {
+		const auto& unigram = languageModel.ngrams[0][wordId];
+		trie.unigrams[wordId].prob =
+			logmath_log10_to_log_float(&lmath, toArpaPrecision(unigram.log10Probability));
+		trie.unigrams[wordId].bo =
+			logmath_log10_to_log_float(&lmath, toArpaPrecision(unigram.log10Backoff));
+		result->word_str[wordId] = ckd_salloc(languageModel.words[wordId].c_str());
+		hash_table_enter_int32(result->wid, result->word_str[wordId], static_cast<int32>(wordId));
+	}
+
+	ngram_raw_t** rawNGrams = static_cast<ngram_raw_t**>(ckd_calloc(order - 1, sizeof(ngram_raw_t*)));
+	auto freeRawNGrams = gsl::finally([&]() { ngrams_raw_free(rawNGrams, counts.data(), order); });
+	for (int n = 2; n <= order; ++n) {
+		const auto& ngrams = languageModel.ngrams[n - 1];
+		rawNGrams[n - 2] = static_cast<ngram_raw_t*>(ckd_calloc(ngrams.size(), sizeof(ngram_raw_t)));
+		for (size_t i = 0; i < ngrams.size(); ++i) {
+			ngram_raw_t& rawNGram = rawNGrams[n - 2][i];
+			rawNGram.order = n;
+			// Like the ARPA reader, narrow higher-order weights to float before converting them
+			rawNGram.prob = logmath_log10_to_log_float(
+				&lmath, static_cast<float>(toArpaPrecision(ngrams[i].log10Probability)));
+			rawNGram.backoff = n < order
+				? logmath_log10_to_log_float(
+					&lmath, static_cast<float>(toArpaPrecision(ngrams[i].log10Backoff)))
+				: 0.0f;
+			// Sphinxbase stores the words in reverse order
+			rawNGram.words = static_cast<uint32*>(ckd_calloc(n, sizeof(uint32)));
+			for (int j = 0; j < n; ++j) {
+				rawNGram.words[n - 1 - j] = static_cast<uint32>(ngrams[i].wordIds[j]);
+			}
+		}
+		qsort(rawNGrams[n - 2], ngrams.size(), sizeof(ngram_raw_t), &ngram_ord_comparator);
+	}
+	lm_trie_build(&trie, rawNGrams, counts.data(), result->n_counts, order);
+
+	// Apply the decoder's language weight and word insertion penalty, as ngram_model_read does
+	ngram_model_apply_weights(
+		result.get(),
+		cmd_ln_float32_r(decoder.config, "-lw"),
+		cmd_ln_float32_r(decoder.config, "-wip")
+	);
+
+	return result;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include "tools/tools.h"
 
@@ -8,7 +9,27 @@ extern "C" {
 #include <ngram_search.h>
 }
 
+// A trigram language model as it would be stored in an ARPA file.
+// It doesn't depend on a decoder, so it can be shared between decoders.
+struct NGramLanguageModel {
+	struct NGram {
+		// Indexes into words; only the first n are used
+		std::array<int, 3> wordIds;
+		double log10Probability;
+		double log10Backoff;
+	};
+
+	// The vocabulary in unigram order
+	std::vector<std::string> words;
+	// The unigrams, bigrams, and trigrams
+	std::array<std::vector<NGram>, 3> ngrams;
+};
+
+// Estimates a trigram language model for the word sequence
+NGramLanguageModel estimateLanguageModel(const std::vector<std::string>& words);
+
+// Creates a PocketSphinx language model in memory
 lambda_unique_ptr<ngram_model_t> createLanguageModel(
-	const std::vector<std::string>& words,
+	const NGramLanguageModel& languageModel,
 	ps_decoder_t& decoder
 );
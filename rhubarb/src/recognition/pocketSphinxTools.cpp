@@ -3,13 +3,18 @@
 #include "tools/platformTools.h"
 #include <regex>
 #include "audio/DcOffset.h"
+#include "audio/SampleRateConverter.h"
 #include "audio/voiceActivityDetection.h"
+#include "audio/processing.h"
+#include <numeric>
+#include <list>
 #include "tools/parallel.h"
-#include "tools/ObjectPool.h"
 #include "time/timedLogging.h"
+#include "tools/profiling.h"
 
 extern "C" {
 #include <sphinxbase/err.h>
+#include <sphinxbase/ckd_alloc.h>
 #include <pocketsphinx_internal.h>
 #include <ngram_search.h>
 }
@@ -17,6 +22,8 @@ extern "C" {
 using std::runtime_error;
 using std::invalid_argument;
 using std::unique_ptr;
+using std::make_unique;
+using std::make_shared;
 using std::string;
 using std::vector;
 using std::filesystem::path;
@@ -82,84 +89,173 @@ void redirectPocketSphinxOutput() {
 	redirected = true;
 }
 
+// A part of the audio to be recognized: either an entire utterance or a window of one
+struct UtteranceTask {
+	TimeRange window;
+	TimeRange core;
+	// If set, receives the phones for stitching instead of the result timeline
+	Timeline<Phone>* windowPhones;
+};
+
+struct SplitUtterance {
+	vector<UtteranceWindow> windows;
+	vector<Timeline<Phone>> windowPhones;
+};
+
+// Returns the start of the 10ms frame within the time range that has the least energy
+centiseconds findQuietestFrame(const MemoryAudioClip& audioClip, TimeRange timeRange) {
+	const gsl::span<const int16_t> samples = audioClip.getSegment(timeRange).getSamples();
+	const size_t frameSize = static_cast<size_t>(audioClip.getSampleRate() / 100);
+	centiseconds result = timeRange.getStart();
+	int64_t minEnergy = std::numeric_limits<int64_t>::max();
+	centiseconds frameStart = timeRange.getStart();
+	for (size_t i = 0; i + frameSize <= samples.size(); i += frameSize) {
+		int64_t energy = 0;
+		for (size_t j = i; j < i + frameSize; ++j) {
+			energy += static_cast<int64_t>(samples[j]) * samples[j];
+		}
+		if (energy < minEnergy) {
+			minEnergy = energy;
+			result = frameStart;
+		}
+		frameStart += 1_cs;
+	}
+	return result;
+}
+
 BoundedTimeline<Phone> recognizePhones(
 	const AudioClip& inputAudioClip,
 	optional<std::string> dialog,
+	DecoderPool& decoderPool,
 	decoderFactory createDecoder,
 	utteranceToPhonesFunction utteranceToPhones,
+	centiseconds maxUtteranceLength,
 	int maxThreadCount,
 	ProgressSink& progressSink
 ) {
 	ProgressMerger totalProgressMerger(progressSink);
+	ProgressSink& decodingProgressSink =
+		totalProgressMerger.addSource("decoding (PocketSphinx tools)", 1.0);
 	ProgressSink& voiceActivationProgressSink =
 		totalProgressMerger.addSource("VAD (PocketSphinx tools)", 1.0);
 	ProgressSink& dialogProgressSink =
 		totalProgressMerger.addSource("recognition (PocketSphinx tools)", 15.0);
 
 	// Make sure audio stream has no DC offset
-	const unique_ptr<AudioClip> audioClip = inputAudioClip.clone() | removeDcOffset();
+	const unique_ptr<AudioClip> audioClip = [&] {
+		profiling::ScopedTimer timer("DC offset");
+		return inputAudioClip.clone() | removeDcOffset();
+	}();
 
-	// Split audio into utterances
-	JoiningBoundedTimeline<void> utterances;
-	try {
-		utterances = detectVoiceActivity(*audioClip, voiceActivationProgressSink);
-	} catch (...) {
-		std::throw_with_nested(runtime_error("Error detecting segments of speech."));
-	}
+	// Decode and resample the audio once. VAD and all utterances read from this buffer.
+	const MemoryAudioClip sphinxAudioClip = [&] {
+		profiling::ScopedTimer timer("decode/resample");
+		return bufferAudioClip(*(audioClip->clone() | resample(sphinxSampleRate)), decodingProgressSink);
+	}();
 
 	redirectPocketSphinxOutput();
 
 	// Prepare pool of decoders
-	ObjectPool<ps_decoder_t, lambda_unique_ptr<ps_decoder_t>> decoderPool(
-		[&] { return createDecoder(dialog); });
+	optional<DecoderPool> dialogDecoderPool;
+	if (dialog) {
+		dialogDecoderPool.emplace([&] { return createDecoder(dialog); });
+	}
+	DecoderPool& decoders = dialogDecoderPool ? *dialogDecoderPool : decoderPool;
 
+	const centiseconds clipDuration = audioClip->getTruncatedRange().getDuration();
 	BoundedTimeline<Phone> phones(audioClip->getTruncatedRange());
 	std::mutex resultMutex;
-	const auto processUtterance = [&](Timed<void> timedUtterance, ProgressSink& utteranceProgressSink) {
+	centiseconds recognizedDuration = 0_cs;
+	const auto processUtterance = [&](UtteranceTask& task) {
 		// Detect phones for utterance
-		const auto decoder = decoderPool.acquire();
+		profiling::ScopedTimer timer("utterance", [&] {
+			return fmt::format("{}-{}", formatDuration(task.window.getStart()), formatDuration(task.window.getEnd()));
+		});
+		profiling::count("utterances");
+		const auto decoder = decoders.acquire();
+		NullProgressSink utteranceProgressSink;
 		Timeline<Phone> utterancePhones = utteranceToPhones(
-			*audioClip,
-			timedUtterance.getTimeRange(),
+			sphinxAudioClip,
+			task.window,
 			*decoder,
 			utteranceProgressSink
 		);
 
-		// Copy phones to result timeline
+		// Copy phones to result timeline, or keep them for stitching
 		std::lock_guard<std::mutex> lock(resultMutex);
-		for (const auto& timedPhone : utterancePhones) {
-			phones.set(timedPhone);
+		if (task.windowPhones) {
+			*task.windowPhones = std::move(utterancePhones);
+		} else {
+			for (const auto& timedPhone : utterancePhones) {
+				phones.set(timedPhone);
+			}
 		}
+		recognizedDuration += task.core.getDuration();
+		dialogProgressSink.reportProgress(
+			std::min(static_cast<double>(recognizedDuration.count()) / clipDuration.count(), 1.0)
+		);
 	};
 
-	const auto getUtteranceProgressWeight = [](const Timed<void> timedUtterance) {
-		return timedUtterance.getDuration().count();
-	};
+	// Long utterances are recognized in windows, whose phones are stitched together at the end
+	std::list<SplitUtterance> splitUtterances;
+	const auto findSplitPoint = [&](TimeRange range) { return findQuietestFrame(sphinxAudioClip, range); };
+
+	// Determine how many parallel threads to use
+	int threadCount = maxThreadCount;
+	if (!ThreadPool::getCurrent()) {
+		// Don't waste time creating additional decoders if the recording is short.
+		// Within a thread pool, decoders are typically reused across files, so this doesn't apply.
+		threadCount = std::min(
+			threadCount,
+			static_cast<int>(duration_cast<std::chrono::seconds>(clipDuration).count() / 5)
+		);
+	}
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
 
-	// Perform speech recognition
+	// Recognize each utterance as soon as VAD has found it, rather than waiting for VAD to finish.
+	// With a single thread, utterances are recognized in order as VAD emits them.
+	logging::debugFormat("Speech recognition using {} threads -- start", threadCount);
+	ParallelQueue<UtteranceTask> utteranceQueue(processUtterance, threadCount);
 	try {
-		// Determine how many parallel threads to use
-		int threadCount = std::min({
+		detectVoiceActivity(
+			sphinxAudioClip,
 			maxThreadCount,
-			// Don't use more threads than there are utterances to be processed
-			static_cast<int>(utterances.size()),
-			// Don't waste time creating additional threads (and decoders!) if the recording is short
-			static_cast<int>(
-				duration_cast<std::chrono::seconds>(audioClip->getTruncatedRange().getDuration()).count() / 5
-			)
-		});
-		if (threadCount < 1) {
-			threadCount = 1;
-		}
-		logging::debugFormat("Speech recognition using {} threads -- start", threadCount);
-		runParallel(
-			"speech recognition (PocketSphinx tools)",
-			processUtterance,
-			utterances,
-			threadCount,
-			dialogProgressSink,
-			getUtteranceProgressWeight
+			voiceActivationProgressSink,
+			[&](const TimeRange& utterance) {
+				vector<UtteranceWindow> windows = splitUtterance(utterance, maxUtteranceLength, findSplitPoint);
+				if (windows.size() == 1) {
+					utteranceQueue.add(UtteranceTask { utterance, utterance, nullptr });
+					return;
+				}
+
+				profiling::count("split utterances");
+				const size_t windowCount = windows.size();
+				splitUtterances.push_back(
+					SplitUtterance { std::move(windows), vector<Timeline<Phone>>(windowCount) }
+				);
+				SplitUtterance& split = splitUtterances.back();
+				for (size_t i = 0; i < windowCount; ++i) {
+					const UtteranceWindow& window = split.windows[i];
+					utteranceQueue.add(
+						UtteranceTask { window.window, window.core, &split.windowPhones[i] }
+					);
+				}
+			}
 		);
+	} catch (...) {
+		std::throw_with_nested(runtime_error("Error detecting segments of speech."));
+	}
+
+	try {
+		utteranceQueue.finish();
+		for (const SplitUtterance& split : splitUtterances) {
+			for (const auto& timedPhone : stitchPhones(split.windows, split.windowPhones)) {
+				phones.set(timedPhone);
+			}
+		}
+		dialogProgressSink.reportProgress(1.0);
 		logging::debug("Speech recognition -- end");
 	} catch (...) {
 		std::throw_with_nested(runtime_error("Error performing speech recognition via PocketSphinx tools."));
@@ -168,6 +264,157 @@ BoundedTimeline<Phone> recognizePhones(
 	return phones;
 }
 
+// Audio around each utterance that is kept for recognition.
+// Must cover the padding utteranceToPhones adds to the utterance.
+constexpr centiseconds utteranceMargin = 10_cs;
+
+// Utterances are cut at the maximum length. Very short utterances hurt recognition.
+constexpr centiseconds minMaxUtteranceLength = 50_cs;
+
+// Recognizes each utterance as soon as VAD reports it complete
+class PocketSphinxPhoneStream : public PhoneStream {
+public:
+	PocketSphinxPhoneStream(
+		int sampleRate,
+		lambda_unique_ptr<ps_decoder_t> decoder,
+		utteranceToPhonesFunction utteranceToPhones,
+		centiseconds maxUtteranceLength
+	);
+	Timeline<Phone> write(gsl::span<const float> samples) override;
+	Timeline<Phone> close() override;
+	centiseconds getCompletedTime() const override;
+private:
+	Timeline<Phone> processSamples(const vector<float>& samples);
+	void recognizeUtterance(TimeRange utteranceTimeRange, Timeline<Phone>& phones);
+
+	StreamingSampleRateConverter sampleRateConverter;
+	VoiceActivityStream activityStream;
+	lambda_unique_ptr<ps_decoder_t> decoder;
+	utteranceToPhonesFunction utteranceToPhones;
+	// Audio that may still be needed for recognition, starting at sample index bufferStart
+	vector<float> buffer;
+	int64_t bufferStart = 0;
+};
+
+constexpr int64_t sphinxSamplesPerCentisecond = sphinxSampleRate / 100;
+
+PocketSphinxPhoneStream::PocketSphinxPhoneStream(
+	int sampleRate,
+	lambda_unique_ptr<ps_decoder_t> decoder,
+	utteranceToPhonesFunction utteranceToPhones,
+	centiseconds maxUtteranceLength
+) :
+	sampleRateConverter(sampleRate, sphinxSampleRate),
+	activityStream(sphinxSampleRate, maxUtteranceLength),
+	decoder(std::move(decoder)),
+	utteranceToPhones(std::move(utteranceToPhones))
+{}
+
+Timeline<Phone> PocketSphinxPhoneStream::write(gsl::span<const float> samples) {
+	vector<float> sphinxSamples;
+	sampleRateConverter.write(samples, sphinxSamples);
+	return processSamples(sphinxSamples);
+}
+
+Timeline<Phone> PocketSphinxPhoneStream::close() {
+	vector<float> sphinxSamples;
+	sampleRateConverter.flush(sphinxSamples);
+	Timeline<Phone> phones = processSamples(sphinxSamples);
+	for (const TimeRange& utterance : activityStream.close()) {
+		recognizeUtterance(utterance, phones);
+	}
+	return phones;
+}
+
+centiseconds PocketSphinxPhoneStream::getCompletedTime() const {
+	// Any future utterance starts no earlier than the open one, and no earlier than the VAD position
+	const centiseconds pendingStart =
+		activityStream.getOpenSegmentStart().value_or(activityStream.getTime());
+	return std::max(0_cs, pendingStart - utteranceMargin);
+}
+
+Timeline<Phone> PocketSphinxPhoneStream::processSamples(const vector<float>& samples) {
+	buffer.insert(buffer.end(), samples.begin(), samples.end());
+
+	// Detect voice activity, recognizing all completed utterances
+	Timeline<Phone> phones;
+	for (const TimeRange& utterance : activityStream.write(samples)) {
+		recognizeUtterance(utterance, phones);
+	}
+
+	// Discard audio that is no longer needed
+	const int64_t discardCount = std::min<int64_t>(
+		getCompletedTime().count() * sphinxSamplesPerCentisecond - bufferStart,
+		static_cast<int64_t>(buffer.size())
+	);
+	if (discardCount > 0) {
+		buffer.erase(buffer.begin(), buffer.begin() + discardCount);
+		bufferStart += discardCount;
+	}
+
+	return phones;
+}
+
+void PocketSphinxPhoneStream::recognizeUtterance(
+	TimeRange utteranceTimeRange,
+	Timeline<Phone>& phones
+) {
+	// Copy the buffered audio around the utterance
+	TimeRange clipRange = utteranceTimeRange;
+	clipRange.grow(utteranceMargin);
+	clipRange.trim(TimeRange(
+		centiseconds(bufferStart / sphinxSamplesPerCentisecond),
+		centiseconds((bufferStart + static_cast<int64_t>(buffer.size())) / sphinxSamplesPerCentisecond)
+	));
+	const auto first =
+		buffer.begin() + (clipRange.getStart().count() * sphinxSamplesPerCentisecond - bufferStart);
+	const auto last = first + clipRange.getDuration().count() * sphinxSamplesPerCentisecond;
+
+	// Remove DC offset
+	const double dcOffset = first == last
+		? 0.0
+		: std::accumulate(first, last, 0.0) / std::distance(first, last);
+	const auto samples = make_shared<vector<int16_t>>();
+	samples->reserve(static_cast<size_t>(std::distance(first, last)));
+	for (auto it = first; it != last; ++it) {
+		samples->push_back(floatSampleToInt16(static_cast<float>(*it - dcOffset)));
+	}
+	const MemoryAudioClip audioClip(samples, sphinxSampleRate);
+
+	// Recognize phones relative to the copied audio
+	TimeRange relativeTimeRange = utteranceTimeRange;
+	relativeTimeRange.shift(-clipRange.getStart());
+	NullProgressSink progressSink;
+	Timeline<Phone> utterancePhones =
+		utteranceToPhones(audioClip, relativeTimeRange, *decoder, progressSink);
+	utterancePhones.shift(clipRange.getStart());
+	for (const auto& timedPhone : utterancePhones) {
+		phones.set(timedPhone);
+	}
+}
+
+unique_ptr<PhoneStream> createPhoneStream(
+	int sampleRate,
+	optional<string> dialog,
+	centiseconds maxDelay,
+	decoderFactory createDecoder,
+	utteranceToPhonesFunction utteranceToPhones
+) {
+	const centiseconds maxUtteranceLength = maxDelay - utteranceMargin;
+	if (maxUtteranceLength < minMaxUtteranceLength) {
+		throw invalid_argument(fmt::format(
+			"Maximum delay must be at least {} for speech recognition.",
+			minMaxUtteranceLength + utteranceMargin
+		));
+	}
+
+	redirectPocketSphinxOutput();
+
+	return make_unique<PocketSphinxPhoneStream>(
+		sampleRate, createDecoder(dialog), std::move(utteranceToPhones), maxUtteranceLength
+	);
+}
+
 const path& getSphinxModelDirectory() {
 	static path sphinxModelDirectory(getBinDirectory() / "res" / "sphinx");
 	return sphinxModelDirectory;
@@ -195,7 +442,64 @@ JoiningTimeline<void> getNoiseSounds(TimeRange utteranceTimeRange, const Timelin
 	return noiseSounds;
 }
 
-BoundedTimeline<string> recognizeWords(const vector<int16_t>& audioBuffer, ps_decoder_t& decoder) {
+UtteranceCepstra::UtteranceCepstra(gsl::span<const int16_t> audioBuffer, ps_decoder_t& decoder) :
+	sampleCount(audioBuffer.size())
+{
+	profiling::ScopedTimer timer("feature extraction");
+
+	// Follow the steps PocketSphinx takes when processing a full utterance of raw audio
+	fe_t* frontEnd = ps_get_fe(&decoder);
+	fe_start_stream(frontEnd);
+	fe_start_utt(frontEnd);
+
+	const int16* nextSample = audioBuffer.data();
+	size_t remainingSamples = audioBuffer.size();
+	int32 maxFrameCount;
+	if (fe_process_frames(frontEnd, nullptr, &remainingSamples, nullptr, &maxFrameCount, nullptr) < 0) {
+		throw runtime_error("Error determining cepstrum frame count.");
+	}
+
+	// Reserve one additional frame for the remaining samples
+	frameSize = fe_get_output_size(frontEnd);
+	values.resize(static_cast<size_t>(maxFrameCount + 1) * frameSize);
+	vector<mfcc_t*> frames(maxFrameCount + 1);
+	for (int i = 0; i <= maxFrameCount; ++i) {
+		frames[i] = &values[static_cast<size_t>(i) * frameSize];
+	}
+
+	int32 processedFrameCount = maxFrameCount;
+	if (fe_process_frames(frontEnd, &nextSample, &remainingSamples, frames.data(), &processedFrameCount, nullptr) < 0) {
+		throw runtime_error("Error computing cepstra.");
+	}
+	int32 tailFrameCount;
+	if (fe_end_utt(frontEnd, frames[processedFrameCount], &tailFrameCount) < 0) {
+		throw runtime_error("Error computing cepstra.");
+	}
+	frameCount = processedFrameCount + tailFrameCount;
+	values.resize(static_cast<size_t>(frameCount) * frameSize);
+	profiling::count("feature frames", frameCount);
+}
+
+int UtteranceCepstra::getFrameCount() const {
+	return frameCount;
+}
+
+centiseconds UtteranceCepstra::getDuration() const {
+	return centiseconds(100 * sampleCount / sphinxSampleRate);
+}
+
+lambda_unique_ptr<mfcc_t*> UtteranceCepstra::copyFrames() const {
+	// Allocate at least one frame, like PocketSphinx does
+	lambda_unique_ptr<mfcc_t*> frames(
+		static_cast<mfcc_t**>(ckd_calloc_2d(std::max(frameCount, 1), frameSize, sizeof(mfcc_t))),
+		[](mfcc_t** frames) { ckd_free_2d(frames); });
+	std::copy(values.begin(), values.end(), frames.get()[0]);
+	return frames;
+}
+
+BoundedTimeline<string> recognizeWords(const UtteranceCepstra& cepstra, ps_decoder_t& decoder) {
+	profiling::ScopedTimer timer("word search");
+
 	// Restart timing at 0
 	ps_start_stream(&decoder);
 
@@ -203,22 +507,21 @@ BoundedTimeline<string> recognizeWords(const vector<int16_t>& audioBuffer, ps_de
 	int error = ps_start_utt(&decoder);
 	if (error) throw runtime_error("Error starting utterance processing for word recognition.");
 
-	// Process entire audio clip
+	// Process entire utterance
+	const lambda_unique_ptr<mfcc_t*> frames = cepstra.copyFrames();
 	const bool noRecognition = false;
 	const bool fullUtterance = true;
 	const int searchedFrameCount =
-		ps_process_raw(&decoder, audioBuffer.data(), audioBuffer.size(), noRecognition, fullUtterance);
+		ps_process_cep(&decoder, frames.get(), cepstra.getFrameCount(), noRecognition, fullUtterance);
 	if (searchedFrameCount < 0) {
-		throw runtime_error("Error analyzing raw audio data for word recognition.");
+		throw runtime_error("Error analyzing cepstra for word recognition.");
 	}
 
 	// End recognition
 	error = ps_end_utt(&decoder);
 	if (error) throw runtime_error("Error ending utterance processing for word recognition.");
 
-	BoundedTimeline<string> result(
-		TimeRange(0_cs, centiseconds(100 * audioBuffer.size() / sphinxSampleRate))
-	);
+	BoundedTimeline<string> result(TimeRange(0_cs, cepstra.getDuration()));
 	const bool phonetic = cmd_ln_boolean_r(decoder.config, "-allphone_ci");
 	if (!phonetic) {
 		// If the decoder is in word mode (as opposed to phonetic recognition), it expects each
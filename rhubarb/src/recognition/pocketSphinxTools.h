@@ -3,7 +3,11 @@
 #include "time/BoundedTimeline.h"
 #include "core/Phone.h"
 #include "audio/AudioClip.h"
+#include "audio/MemoryAudioClip.h"
 #include "tools/progress.h"
+#include "Recognizer.h"
+#include "tools/ObjectPool.h"
+#include "utteranceSplitting.h"
 #include <filesystem>
 
 extern "C" {
@@ -15,28 +19,63 @@ typedef std::function<lambda_unique_ptr<ps_decoder_t>(
 )> decoderFactory;
 
 typedef std::function<Timeline<Phone>(
-	const AudioClip& audioClip,
+	const MemoryAudioClip& audioClip,
 	TimeRange utteranceTimeRange,
 	ps_decoder_t& decoder,
 	ProgressSink& utteranceProgressSink
 )> utteranceToPhonesFunction;
 
+using DecoderPool = ObjectPool<ps_decoder_t, lambda_unique_ptr<ps_decoder_t>>;
+
+// Decoders for a dialog are specific to it and discarded afterwards. Without dialog, decoders are
+// taken from the specified pool, where they stay available for subsequent calls.
+// Utterances longer than maxUtteranceLength are split into windows that are recognized in parallel.
 BoundedTimeline<Phone> recognizePhones(
 	const AudioClip& inputAudioClip,
 	boost::optional<std::string> dialog,
+	DecoderPool& decoderPool,
 	decoderFactory createDecoder,
 	utteranceToPhonesFunction utteranceToPhones,
+	centiseconds maxUtteranceLength,
 	int maxThreadCount,
 	ProgressSink& progressSink
 );
 
+std::unique_ptr<PhoneStream> createPhoneStream(
+	int sampleRate,
+	boost::optional<std::string> dialog,
+	centiseconds maxDelay,
+	decoderFactory createDecoder,
+	utteranceToPhonesFunction utteranceToPhones
+);
+
 constexpr int sphinxSampleRate = 16000;
 
 const std::filesystem::path& getSphinxModelDirectory();
 
 JoiningTimeline<void> getNoiseSounds(TimeRange utteranceTimeRange, const Timeline<Phone>& phones);
 
+// The cepstral feature frames of an utterance. Computing them once lets several decoding passes
+// share them.
+class UtteranceCepstra {
+public:
+	// Computes the cepstra using the decoder's front end
+	UtteranceCepstra(gsl::span<const int16_t> audioBuffer, ps_decoder_t& decoder);
+
+	int getFrameCount() const;
+	centiseconds getDuration() const;
+
+	// Returns a copy of the frames, since decoding modifies them in place
+	lambda_unique_ptr<mfcc_t*> copyFrames() const;
+
+private:
+	std::vector<mfcc_t> values;
+	int frameCount;
+	int frameSize;
+	size_t sampleCount;
+};
+
 BoundedTimeline<std::string> recognizeWords(
-	const std::vector<int16_t>& audioBuffer,
+	const UtteranceCepstra& cepstra,
 	ps_decoder_t& decoder
 );
@@ -0,0 +1,115 @@
+#include "utteranceSplitting.h"
+#include <algorithm>
+#include <format.h>
+
+using std::vector;
+using std::function;
+using std::invalid_argument;
+
+// Audio a window includes beyond its core, on either side. Recognition is unreliable close to the
+// edges of a window, so the overlap lets the next window take over away from them.
+constexpr centiseconds windowMargin = 100_cs;
+
+// How far a split point may be moved to find a quiet frame
+constexpr centiseconds maxSplitPointShift = 200_cs;
+
+vector<UtteranceWindow> splitUtterance(
+	TimeRange utterance,
+	centiseconds maxLength,
+	const function<centiseconds(TimeRange)>& findSplitPoint
+) {
+	if (maxLength < minUtteranceSplitLength) {
+		throw invalid_argument(fmt::format(
+			"Maximum utterance length must be at least {}.", minUtteranceSplitLength
+		));
+	}
+
+	if (utterance.getDuration() <= maxLength) {
+		return { UtteranceWindow { utterance, utterance } };
+	}
+
+	// Space the split points so that cores stay short enough after moving them
+	const centiseconds maxCoreLength = maxLength - 2 * windowMargin;
+	const centiseconds splitPointShift = std::min(maxSplitPointShift, maxCoreLength / 8);
+	const centiseconds maxSpacing = maxCoreLength - 2 * splitPointShift;
+	const int windowCount = static_cast<int>(
+		(utterance.getDuration().count() + maxSpacing.count() - 1) / maxSpacing.count()
+	);
+
+	vector<UtteranceWindow> windows;
+	centiseconds coreStart = utterance.getStart();
+	for (int i = 1; i <= windowCount; ++i) {
+		centiseconds coreEnd = utterance.getEnd();
+		if (i < windowCount) {
+			const centiseconds nominalSplitPoint =
+				utterance.getStart() + utterance.getDuration() * i / windowCount;
+			coreEnd = findSplitPoint(TimeRange(
+				std::max(nominalSplitPoint - splitPointShift, coreStart + 1_cs),
+				nominalSplitPoint + splitPointShift
+			));
+		}
+		const TimeRange window(
+			std::max(coreStart - windowMargin, utterance.getStart()),
+			std::min(coreEnd + windowMargin, utterance.getEnd())
+		);
+		windows.push_back(UtteranceWindow { window, TimeRange(coreStart, coreEnd) });
+		coreStart = coreEnd;
+	}
+	return windows;
+}
+
+bool isPhoneInProgress(const Timeline<Phone>& phones, centiseconds time) {
+	const auto it = phones.find(time, FindMode::SampleLeft);
+	return it != phones.end() && it->getStart() < time && it->getEnd() > time;
+}
+
+// Finds the time close to the split point where both windows are between phones
+centiseconds findStitchPoint(
+	centiseconds splitPoint,
+	centiseconds maxDistance,
+	const Timeline<Phone>& phonesBefore,
+	const Timeline<Phone>& phonesAfter
+) {
+	for (centiseconds distance = 0_cs; distance <= maxDistance; distance += 1_cs) {
+		for (centiseconds time : { splitPoint - distance, splitPoint + distance }) {
+			if (!isPhoneInProgress(phonesBefore, time) && !isPhoneInProgress(phonesAfter, time)) {
+				return time;
+			}
+		}
+	}
+	return splitPoint;
+}
+
+Timeline<Phone> stitchPhones(
+	const vector<UtteranceWindow>& windows,
+	const vector<Timeline<Phone>>& windowPhones
+) {
+	if (windowPhones.size() != windows.size()) {
+		throw invalid_argument("Phones are required for each window.");
+	}
+
+	Timeline<Phone> result;
+	centiseconds start = windows.empty() ? 0_cs : windows.front().window.getStart();
+	for (size_t i = 0; i < windows.size(); ++i) {
+		centiseconds end = windows[i].window.getEnd();
+		if (i + 1 < windows.size()) {
+			// Cores can be short, so don't search beyond half of either core. Otherwise, the
+			// stitch point could end up before the previous one, dropping the phones in between.
+			const centiseconds maxDistance = std::min({
+				windowMargin / 2,
+				windows[i].core.getDuration() / 2,
+				windows[i + 1].core.getDuration() / 2
+			});
+			end = findStitchPoint(windows[i].core.getEnd(), maxDistance, windowPhones[i], windowPhones[i + 1]);
+		}
+		for (const Timed<Phone>& timedPhone : windowPhones[i]) {
+			const centiseconds phoneStart = std::max(timedPhone.getStart(), start);
+			const centiseconds phoneEnd = std::min(timedPhone.getEnd(), end);
+			if (phoneStart < phoneEnd) {
+				result.set(phoneStart, phoneEnd, timedPhone.getValue());
+			}
+		}
+		start = end;
+	}
+	return result;
+}
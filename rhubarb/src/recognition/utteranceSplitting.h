@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "core/Phone.h"
+#include "time/Timeline.h"
+
+// Utterances above the maximum length can't use more than one thread and need a lot of memory.
+// They are split into overlapping windows that are recognized independently.
+
+constexpr centiseconds defaultMaxUtteranceLength = 2000_cs;
+
+// The maximum utterance length can't be set lower than this
+constexpr centiseconds minUtteranceSplitLength = 500_cs;
+
+// A window of an utterance. Phones are recognized across the whole window; the core is the part
+// the window is responsible for. The cores of adjacent windows meet at a split point.
+struct UtteranceWindow {
+	TimeRange window;
+	TimeRange core;
+};
+
+// Splits the utterance into windows no longer than maxLength, or returns a single window if it is
+// short enough. For each split, findSplitPoint is called with a time range and should return the
+// point within it that is best suited for splitting, such as the quietest frame.
+std::vector<UtteranceWindow> splitUtterance(
+	TimeRange utterance,
+	centiseconds maxLength,
+	const std::function<centiseconds(TimeRange)>& findSplitPoint
+);
+
+// Combines the phones recognized in each window. Near each split point, switches from one window
+// to the next at a time where neither window has a phone in progress.
+Timeline<Phone> stitchPhones(
+	const std::vector<UtteranceWindow>& windows,
+	const std::vector<Timeline<Phone>>& windowPhones
+);
@@ -4,7 +4,8 @@
 
 enum class RecognizerType {
 	PocketSphinx,
-	Phonetic
+	Phonetic,
+	PhoneticDraft
 };
 
 class RecognizerTypeConverter : public EnumConverter<RecognizerType> {
@@ -0,0 +1,129 @@
+#include "batch.h"
+#include <atomic>
+#include <fstream>
+#include <numeric>
+#include <boost/algorithm/string/trim.hpp>
+#include <format.h>
+#include "lib/rhubarbLib.h"
+#include "logging/logging.h"
+#include "tools/exceptions.h"
+#include "tools/parallel.h"
+#include "tools/profiling.h"
+#include "tools/stringTools.h"
+#include "tools/textFiles.h"
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::filesystem::path;
+using std::filesystem::u8path;
+using boost::optional;
+
+vector<BatchEntry> readBatchManifest(
+	const path& manifestFilePath,
+	ExportFormat exportFormat,
+	const optional<path>& outputDirectory
+) {
+	const string extension = "." + ExportFormatConverter::get().toString(exportFormat);
+	vector<BatchEntry> entries;
+	for (string line : splitIntoLines(readUtf8File(manifestFilePath))) {
+		boost::algorithm::trim_right(line);
+		if (line.empty()) continue;
+
+		BatchEntry entry;
+		const size_t separatorIndex = line.find('\t');
+		entry.inputFilePath = u8path(line.substr(0, separatorIndex));
+		if (separatorIndex != string::npos) {
+			entry.dialogFilePath = u8path(line.substr(separatorIndex + 1));
+		}
+		path outputFileName = entry.inputFilePath.filename().replace_extension(extension);
+		entry.outputFilePath = outputDirectory
+			? *outputDirectory / outputFileName
+			: path(entry.inputFilePath).replace_extension(extension);
+		entries.push_back(entry);
+	}
+	return entries;
+}
+
+void animateBatchEntry(
+	const BatchEntry& entry,
+	const Recognizer& recognizer,
+	const JobSettings& settings,
+	int maxThreadCount,
+	ProgressSink& progressSink
+) {
+	try {
+		logging::infoFormat("Starting animation of {}.", entry.inputFilePath.u8string());
+		const optional<string> dialog = entry.dialogFilePath
+			? readUtf8File(*entry.dialogFilePath)
+			: optional<string>();
+		const ShapeSet targetShapeSet = getTargetShapeSet(settings.extendedShapes);
+		const JoiningContinuousTimeline<Shape> animation = animateWaveFile(
+			entry.inputFilePath,
+			dialog,
+			recognizer,
+			targetShapeSet,
+			maxThreadCount,
+			progressSink
+		);
+
+		{
+			profiling::ScopedTimer timer("export");
+			std::ofstream outputFile(entry.outputFilePath);
+			outputFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+			createExporter(settings, targetShapeSet)->exportAnimation(
+				ExporterInput(entry.inputFilePath, animation, targetShapeSet),
+				outputFile
+			);
+		}
+		logging::infoFormat(
+			"Done animating {}. Output written to {}.",
+			entry.inputFilePath.u8string(),
+			entry.outputFilePath.u8string()
+		);
+	} catch (...) {
+		std::throw_with_nested(std::runtime_error(
+			fmt::format("Error processing file {}.", entry.inputFilePath.u8string())
+		));
+	}
+}
+
+int animateBatch(
+	const vector<BatchEntry>& entries,
+	const JobSettings& settings,
+	int maxThreadCount,
+	ProgressSink& progressSink
+) {
+	const unique_ptr<Recognizer> recognizer = createRecognizer(
+		settings.recognizerType, settings.maxUtteranceLength, settings.cacheDirectory
+	);
+
+	ProgressMerger progressMerger(progressSink);
+	vector<ProgressSink*> entryProgressSinks;
+	for (const BatchEntry& entry : entries) {
+		entryProgressSinks.push_back(&progressMerger.addSource(entry.inputFilePath.u8string(), 1.0));
+	}
+
+	std::atomic<int> failureCount(0);
+	ThreadPool threadPool(maxThreadCount);
+	vector<size_t> entryIndices(entries.size());
+	std::iota(entryIndices.begin(), entryIndices.end(), 0);
+	runParallel(
+		threadPool,
+		[&](size_t entryIndex) {
+			ProgressSink& entryProgressSink = *entryProgressSinks[entryIndex];
+			try {
+				animateBatchEntry(
+					entries[entryIndex], *recognizer, settings, maxThreadCount, entryProgressSink
+				);
+			} catch (const std::exception& e) {
+				logging::error(getMessage(e));
+				++failureCount;
+			}
+			entryProgressSink.reportProgress(1.0);
+		},
+		entryIndices
+	);
+
+	return failureCount;
+}
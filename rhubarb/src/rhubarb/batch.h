@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <boost/optional.hpp>
+#include "factories.h"
+#include "tools/progress.h"
+
+// A file to animate in batch mode
+struct BatchEntry {
+	std::filesystem::path inputFilePath;
+	boost::optional<std::filesystem::path> dialogFilePath;
+	std::filesystem::path outputFilePath;
+};
+
+// Reads a manifest containing one input file per line, optionally followed by a tab and a dialog
+// file. Each output file is named after its input file, with the export format as extension. It is
+// placed in the output directory, if specified, or next to the input file.
+std::vector<BatchEntry> readBatchManifest(
+	const std::filesystem::path& manifestFilePath,
+	ExportFormat exportFormat,
+	const boost::optional<std::filesystem::path>& outputDirectory
+);
+
+// Animates and exports all entries. All files are processed using a single thread pool, so that
+// the utterances of all files share its workers. A failing file doesn't affect the others.
+// Returns the number of failed files.
+int animateBatch(
+	const std::vector<BatchEntry>& entries,
+	const JobSettings& settings,
+	int maxThreadCount,
+	ProgressSink& progressSink
+);
@@ -0,0 +1,88 @@
+#include "factories.h"
+#include "exporters/DatExporter.h"
+#include "exporters/TsvExporter.h"
+#include "exporters/XmlExporter.h"
+#include "exporters/JsonExporter.h"
+#include "recognition/PocketSphinxRecognizer.h"
+#include "recognition/PhoneticRecognizer.h"
+#include "recognition/CachingRecognizer.h"
+#include <format.h>
+
+using std::string;
+using std::unique_ptr;
+using std::make_unique;
+using std::filesystem::path;
+using boost::optional;
+
+static unique_ptr<Recognizer> createUncachedRecognizer(
+	RecognizerType recognizerType,
+	centiseconds maxUtteranceLength
+) {
+	switch (recognizerType) {
+		case RecognizerType::PocketSphinx:
+			return make_unique<PocketSphinxRecognizer>(maxUtteranceLength);
+		case RecognizerType::Phonetic:
+			return make_unique<PhoneticRecognizer>(maxUtteranceLength);
+		case RecognizerType::PhoneticDraft:
+			return make_unique<PhoneticRecognizer>(maxUtteranceLength, PhoneticQuality::Draft);
+		default:
+			throw std::runtime_error("Unknown recognizer.");
+	}
+}
+
+unique_ptr<Recognizer> createRecognizer(
+	RecognizerType recognizerType,
+	centiseconds maxUtteranceLength,
+	const optional<path>& cacheDirectory
+) {
+	unique_ptr<Recognizer> recognizer = createUncachedRecognizer(recognizerType, maxUtteranceLength);
+	if (!cacheDirectory) return recognizer;
+
+	const string recognizerKey = fmt::format(
+		"{} maxUtteranceLength={}",
+		RecognizerTypeConverter::get().toString(recognizerType),
+		maxUtteranceLength.count()
+	);
+	return make_unique<CachingRecognizer>(std::move(recognizer), recognizerKey, *cacheDirectory);
+}
+
+unique_ptr<Exporter> createExporter(
+	ExportFormat exportFormat,
+	const ShapeSet& targetShapeSet,
+	double datFrameRate,
+	bool datUsePrestonBlair
+) {
+	switch (exportFormat) {
+		case ExportFormat::Dat:
+			return make_unique<DatExporter>(targetShapeSet, datFrameRate, datUsePrestonBlair);
+		case ExportFormat::Tsv:
+			return make_unique<TsvExporter>();
+		case ExportFormat::Xml:
+			return make_unique<XmlExporter>();
+		case ExportFormat::Json:
+			return make_unique<JsonExporter>();
+		default:
+			throw std::runtime_error("Unknown export format.");
+	}
+}
+
+unique_ptr<Exporter> createExporter(const JobSettings& settings, const ShapeSet& targetShapeSet) {
+	return createExporter(
+		settings.exportFormat,
+		targetShapeSet,
+		settings.datFrameRate,
+		settings.datUsePrestonBlair
+	);
+}
+
+ShapeSet getTargetShapeSet(const string& extendedShapesString) {
+	// All basic shapes are mandatory
+	ShapeSet result(ShapeConverter::get().getBasicShapes());
+
+	// Add any extended shapes
+	for (char ch : extendedShapesString) {
+		Shape shape = ShapeConverter::get().parse(string(1, ch));
+		result.insert(shape);
+	}
+	return result;
+}
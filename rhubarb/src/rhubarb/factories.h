@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "core/Shape.h"
+#include "exporters/Exporter.h"
+#include "recognition/Recognizer.h"
+#include "ExportFormat.h"
+#include "RecognizerType.h"
+
+// If a cache directory is specified, recognition results are cached there
+std::unique_ptr<Recognizer> createRecognizer(
+	RecognizerType recognizerType,
+	centiseconds maxUtteranceLength,
+	const boost::optional<std::filesystem::path>& cacheDirectory
+);
+
+std::unique_ptr<Exporter> createExporter(
+	ExportFormat exportFormat,
+	const ShapeSet& targetShapeSet,
+	double datFrameRate,
+	bool datUsePrestonBlair
+);
+
+ShapeSet getTargetShapeSet(const std::string& extendedShapesString);
+
+// Settings for animating a single file
+struct JobSettings {
+	RecognizerType recognizerType;
+	ExportFormat exportFormat;
+	std::string extendedShapes;
+	double datFrameRate;
+	bool datUsePrestonBlair;
+	centiseconds maxUtteranceLength;
+	boost::optional<std::filesystem::path> cacheDirectory;
+};
+
+std::unique_ptr<Exporter> createExporter(const JobSettings& settings, const ShapeSet& targetShapeSet);
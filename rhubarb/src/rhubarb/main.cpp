@@ -17,20 +17,20 @@
 #include "tools/textFiles.h"
 #include "lib/rhubarbLib.h"
 #include "ExportFormat.h"
-#include "exporters/DatExporter.h"
 #include "exporters/TsvExporter.h"
-#include "exporters/XmlExporter.h"
-#include "exporters/JsonExporter.h"
 #include "animation/targetShapeSet.h"
 #include <boost/utility/in_place_factory.hpp>
 #include "tools/platformTools.h"
+#include "tools/profiling.h"
+#include "recognition/utteranceSplitting.h"
 #include "sinks/MachineReadableStderrSink.h"
 #include "sinks/NiceStderrSink.h"
 #include "sinks/QuietStderrSink.h"
 #include "semanticEntries.h"
 #include "RecognizerType.h"
-#include "recognition/PocketSphinxRecognizer.h"
-#include "recognition/PhoneticRecognizer.h"
+#include "factories.h"
+#include "server.h"
+#include "batch.h"
 
 using std::exception;
 using std::string;
@@ -74,47 +74,57 @@ shared_ptr<logging::Sink> createFileSink(const path& path, logging::Level minLev
 	return make_shared<logging::LevelFilter>(FileSink, minLevel);
 }
 
-unique_ptr<Recognizer> createRecognizer(RecognizerType recognizerType) {
-	switch (recognizerType) {
-		case RecognizerType::PocketSphinx:
-			return make_unique<PocketSphinxRecognizer>();
-		case RecognizerType::Phonetic:
-			return make_unique<PhoneticRecognizer>();
-		default:
-			throw std::runtime_error("Unknown recognizer.");
-	}
-}
-
-unique_ptr<Exporter> createExporter(
-	ExportFormat exportFormat,
+void streamAnimation(
+	int sampleRate,
+	double maxLatencySeconds,
+	const optional<string>& dialog,
+	const Recognizer& recognizer,
 	const ShapeSet& targetShapeSet,
-	double datFrameRate,
-	bool datUsePrestonBlair
+	const optional<path>& outputFilePath
 ) {
-	switch (exportFormat) {
-		case ExportFormat::Dat:
-			return make_unique<DatExporter>(targetShapeSet, datFrameRate, datUsePrestonBlair);
-		case ExportFormat::Tsv:
-			return make_unique<TsvExporter>();
-		case ExportFormat::Xml:
-			return make_unique<XmlExporter>();
-		case ExportFormat::Json:
-			return make_unique<JsonExporter>();
-		default:
-			throw std::runtime_error("Unknown export format.");
+	try {
+		optional<std::ofstream> outputFile;
+		if (outputFilePath) {
+			outputFile = boost::in_place(*outputFilePath);
+			outputFile->exceptions(std::ifstream::failbit | std::ifstream::badbit);
+		}
+		TsvStreamExporter exporter(targetShapeSet, outputFile ? *outputFile : std::cout);
+
+		useBinaryModeForStdin();
+		logging::info("Starting streaming animation.");
+		animateAudioStream(
+			std::cin,
+			sampleRate,
+			dialog,
+			recognizer,
+			targetShapeSet,
+			centiseconds(static_cast<int>(std::lround(maxLatencySeconds * 100))),
+			[&](const JoiningContinuousTimeline<Shape>& animation) {
+				exporter.exportAnimation(animation);
+			}
+		);
+		exporter.finish();
+		logging::info("Done streaming animation.");
+	} catch (...) {
+		std::throw_with_nested(std::runtime_error("Error processing audio stream."));
 	}
 }
 
-ShapeSet getTargetShapeSet(const string& extendedShapesString) {
-	// All basic shapes are mandatory
-	ShapeSet result(ShapeConverter::get().getBasicShapes());
-
-	// Add any extended shapes
-	for (char ch : extendedShapesString) {
-		Shape shape = ShapeConverter::get().parse(string(1, ch));
-		result.insert(shape);
+// Prints the profiling summary and writes the trace file. Must not throw, since it runs while
+// leaving scope.
+void writeProfilingReport(const path& traceFilePath, bool printSummary) noexcept {
+	try {
+		if (printSummary) {
+			std::cerr << std::endl;
+			profiling::printSummary(std::cerr);
+		}
+		std::ofstream traceFile;
+		traceFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+		traceFile.open(traceFilePath);
+		profiling::writeChromeTrace(traceFile);
+	} catch (const exception& e) {
+		logging::errorFormat("Error writing profiling report: {}", getMessage(e));
 	}
-	return result;
 }
 
 int main(int platformArgc, char* platformArgv[]) {
@@ -205,9 +215,57 @@ int main(int platformArgc, char* platformArgv[]) {
 		false, RecognizerType::PocketSphinx, &recognizerConstraint, cmd
 	);
 
+	tclap::ValueArg<string> batchFileName(
+		"", "batch",
+		"Animates all files listed in the specified manifest, one per line. Use -o for the output directory.",
+		false, string(), "string", cmd
+	);
+
+	tclap::SwitchArg serverMode(
+		"", "server",
+		"Runs as a server, reading jobs as JSON lines from stdin and writing results to stdout.",
+		cmd, false
+	);
+
+	tclap::SwitchArg streamMode(
+		"", "stream",
+		"Reads raw audio from stdin, writing mouth cues as soon as they are final. Uses tsv format.",
+		cmd, false
+	);
+
+	tclap::ValueArg<int> streamSampleRate(
+		"", "streamSampleRate",
+		"Only for stream mode: the sample rate of the audio, which must be 16-bit signed little-endian mono.",
+		false, 16000, "number", cmd
+	);
+
+	tclap::ValueArg<double> streamLatency(
+		"", "streamLatency",
+		"Only for stream mode: the maximum time in seconds by which mouth cues lag behind the audio.",
+		false, 2.5, "number", cmd
+	);
+
+	tclap::ValueArg<double> maxUtteranceLength(
+		"", "maxUtteranceLength",
+		"The maximum length in seconds of an utterance. Longer utterances are split and recognized in parallel.",
+		false, defaultMaxUtteranceLength.count() / 100.0, "number", cmd
+	);
+
+	tclap::ValueArg<string> cacheDirectory(
+		"", "cacheDir",
+		"Caches recognition results in the specified directory, so that processing the same audio again is fast.",
+		false, string(), "string", cmd
+	);
+
+	tclap::ValueArg<string> profileFileName(
+		"", "profile",
+		"Measures the time spent in each processing stage. Prints a summary and writes a Chrome trace file to the specified path.",
+		false, string(), "string", cmd
+	);
+
 	tclap::UnlabeledValueArg<string> inputFileName(
 		"inputFile", "The input file. Must be a sound file in WAVE format.",
-		true, "", "string", cmd
+		false, "", "string", cmd
 	);
 
 	try {
@@ -217,6 +275,18 @@ int main(int platformArgc, char* platformArgv[]) {
 			vector<string> argsCopy(args);
 			cmd.parse(argsCopy);
 		}
+		const int modeCount = static_cast<int>(batchFileName.isSet())
+			+ static_cast<int>(serverMode.getValue())
+			+ static_cast<int>(streamMode.getValue());
+		if (modeCount > 1) {
+			throw tclap::CmdLineParseException("Batch, server and stream mode are mutually exclusive.");
+		}
+		if (modeCount == 0 && !inputFileName.isSet()) {
+			throw tclap::CmdLineParseException("Required argument missing: inputFile");
+		}
+		if (modeCount > 0 && inputFileName.isSet()) {
+			throw tclap::CmdLineParseException("This mode doesn't take an input file.");
+		}
 
 		// Set up logging
 		// ... to stderr
@@ -234,13 +304,93 @@ int main(int platformArgc, char* platformArgv[]) {
 			logging::addSink(fileSink);
 		}
 
+		// Set up profiling. The report is written regardless of how processing ends.
+		if (profileFileName.isSet()) {
+			profiling::enable();
+		}
+		auto reportProfile = gsl::finally([&]() {
+			if (!profileFileName.isSet()) return;
+			// Machine-readable output to stderr must stay valid JSON
+			writeProfilingReport(u8path(profileFileName.getValue()), !machineReadableMode.getValue());
+		});
+
 		// Validate and transform command line arguments
 		if (maxThreadCount.getValue() < 1) {
 			throw std::runtime_error("Thread count must be 1 or higher.");
 		}
-		path inputFilePath = u8path(inputFileName.getValue());
+		const centiseconds maxUtteranceLengthCs(
+			static_cast<int>(std::lround(maxUtteranceLength.getValue() * 100))
+		);
+		if (maxUtteranceLengthCs < minUtteranceSplitLength) {
+			throw std::runtime_error(fmt::format(
+				"Maximum utterance length must be at least {} seconds.", minUtteranceSplitLength.count() / 100
+			));
+		}
 		ShapeSet targetShapeSet = getTargetShapeSet(extendedShapes.getValue());
 
+		const JobSettings jobSettings {
+			recognizerType.getValue(),
+			exportFormat.getValue(),
+			extendedShapes.getValue(),
+			datFrameRate.getValue(),
+			datUsePrestonBlair.getValue(),
+			maxUtteranceLengthCs,
+			cacheDirectory.isSet() ? u8path(cacheDirectory.getValue()) : optional<path>()
+		};
+
+		if (batchFileName.isSet()) {
+			const path manifestFilePath = u8path(batchFileName.getValue());
+			logging::log(StartEntry(manifestFilePath));
+			const vector<BatchEntry> entries = readBatchManifest(
+				manifestFilePath,
+				exportFormat.getValue(),
+				outputFileName.isSet() ? u8path(outputFileName.getValue()) : optional<path>()
+			);
+			ProgressForwarder progressSink([](double progress) {
+				logging::log(ProgressEntry(progress));
+			});
+			const int failureCount =
+				animateBatch(entries, jobSettings, maxThreadCount.getValue(), progressSink);
+			if (failureCount > 0) {
+				throw std::runtime_error(
+					fmt::format("Failed to process {} of {} files.", failureCount, entries.size())
+				);
+			}
+			logging::log(SuccessEntry());
+			return 0;
+		}
+
+		if (serverMode.getValue()) {
+			logging::log(StartEntry(u8path("-")));
+			runServer(std::cin, std::cout, jobSettings, maxThreadCount.getValue());
+			logging::log(SuccessEntry());
+			return 0;
+		}
+
+		if (streamMode.getValue()) {
+			if (exportFormat.getValue() != ExportFormat::Tsv) {
+				throw std::runtime_error("Stream mode only supports the tsv export format.");
+			}
+
+			logging::log(StartEntry(u8path("-")));
+			streamAnimation(
+				streamSampleRate.getValue(),
+				streamLatency.getValue(),
+				dialogFile.isSet()
+					? readUtf8File(u8path(dialogFile.getValue()))
+					: boost::optional<string>(),
+				*createRecognizer(
+					recognizerType.getValue(), jobSettings.maxUtteranceLength, jobSettings.cacheDirectory
+				),
+				targetShapeSet,
+				outputFileName.isSet() ? u8path(outputFileName.getValue()) : optional<path>()
+			);
+			logging::log(SuccessEntry());
+			return 0;
+		}
+
+		path inputFilePath = u8path(inputFileName.getValue());
+
 		unique_ptr<Exporter> exporter = createExporter(
 			exportFormat.getValue(),
 			targetShapeSet,
@@ -265,7 +415,9 @@ int main(int platformArgc, char* platformArgv[]) {
 				dialogFile.isSet()
 					? readUtf8File(u8path(dialogFile.getValue()))
 					: boost::optional<string>(),
-				*createRecognizer(recognizerType.getValue()),
+				*createRecognizer(
+					recognizerType.getValue(), jobSettings.maxUtteranceLength, jobSettings.cacheDirectory
+				),
 				targetShapeSet,
 				maxThreadCount.getValue(),
 				progressSink);
@@ -279,7 +431,10 @@ int main(int platformArgc, char* platformArgv[]) {
 			}
 			ExporterInput exporterInput = ExporterInput(inputFilePath, animation, targetShapeSet);
 			logging::info("Starting export.");
-			exporter->exportAnimation(exporterInput, outputFile ? *outputFile : std::cout);
+			{
+				profiling::ScopedTimer timer("export");
+				exporter->exportAnimation(exporterInput, outputFile ? *outputFile : std::cout);
+			}
 			logging::info("Done exporting.");
 
 			logging::log(SuccessEntry());
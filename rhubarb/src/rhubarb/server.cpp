@@ -0,0 +1,162 @@
+#include "server.h"
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/utility/in_place_factory.hpp>
+#include <format.h>
+#include "factories.h"
+#include "lib/rhubarbLib.h"
+#include "logging/logging.h"
+#include "tools/exceptions.h"
+#include "tools/profiling.h"
+#include "tools/stringTools.h"
+#include "tools/textFiles.h"
+
+using std::string;
+using std::map;
+using std::unique_ptr;
+using std::filesystem::path;
+using std::filesystem::u8path;
+using boost::optional;
+using boost::property_tree::ptree;
+
+class Server {
+public:
+	Server(const JobSettings& defaultSettings, int maxThreadCount);
+
+	// Processes the job described by the specified JSON, returning a JSON result
+	string processJob(const string& jobJson);
+
+private:
+	const Recognizer& getRecognizer(RecognizerType recognizerType);
+
+	JobSettings defaultSettings;
+	int maxThreadCount;
+	map<RecognizerType, unique_ptr<Recognizer>> recognizers;
+};
+
+Server::Server(const JobSettings& defaultSettings, int maxThreadCount) :
+	defaultSettings(defaultSettings),
+	maxThreadCount(maxThreadCount)
+{}
+
+const Recognizer& Server::getRecognizer(RecognizerType recognizerType) {
+	unique_ptr<Recognizer>& recognizer = recognizers[recognizerType];
+	if (!recognizer) {
+		recognizer = createRecognizer(
+			recognizerType, defaultSettings.maxUtteranceLength, defaultSettings.cacheDirectory
+		);
+	}
+	return *recognizer;
+}
+
+string Server::processJob(const string& jobJson) {
+	optional<string> jobId;
+	try {
+		ptree job;
+		try {
+			std::istringstream jobStream(jobJson);
+			boost::property_tree::read_json(jobStream, job);
+		} catch (...) {
+			std::throw_with_nested(std::runtime_error("Invalid job JSON."));
+		}
+		jobId = job.get_optional<string>("id");
+
+		// Read job settings
+		const auto inputFileName = job.get_optional<string>("inputFile");
+		if (!inputFileName) throw std::runtime_error("Job has no input file.");
+		const path inputFilePath = u8path(*inputFileName);
+		optional<string> dialog = job.get_optional<string>("dialog");
+		if (const auto dialogFileName = job.get_optional<string>("dialogFile")) {
+			dialog = readUtf8File(u8path(*dialogFileName));
+		}
+		const auto recognizerName = job.get_optional<string>("recognizer");
+		const RecognizerType recognizerType = recognizerName
+			? RecognizerTypeConverter::get().parse(*recognizerName)
+			: defaultSettings.recognizerType;
+		const auto exportFormatName = job.get_optional<string>("exportFormat");
+		const ExportFormat exportFormat = exportFormatName
+			? ExportFormatConverter::get().parse(*exportFormatName)
+			: defaultSettings.exportFormat;
+		const ShapeSet targetShapeSet = getTargetShapeSet(
+			job.get<string>("extendedShapes", defaultSettings.extendedShapes)
+		);
+		const unique_ptr<Exporter> exporter = createExporter(
+			exportFormat,
+			targetShapeSet,
+			job.get<double>("datFrameRate", defaultSettings.datFrameRate),
+			job.get<bool>("datUsePrestonBlair", defaultSettings.datUsePrestonBlair)
+		);
+		const optional<string> outputFileName = job.get_optional<string>("outputFile");
+
+		try {
+			// Animate the recording
+			logging::infoFormat("Starting job for file {}.", inputFilePath.u8string());
+			NullProgressSink progressSink;
+			const JoiningContinuousTimeline<Shape> animation = animateWaveFile(
+				inputFilePath,
+				dialog,
+				getRecognizer(recognizerType),
+				targetShapeSet,
+				maxThreadCount,
+				progressSink
+			);
+
+			// Export animation
+			const ExporterInput exporterInput(inputFilePath, animation, targetShapeSet);
+			string result;
+			{
+				profiling::ScopedTimer timer("export");
+				if (outputFileName) {
+					std::ofstream outputFile(u8path(*outputFileName));
+					outputFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+					exporter->exportAnimation(exporterInput, outputFile);
+					result = fmt::format(R"("outputFile": "{}")", escapeJsonString(*outputFileName));
+				} else {
+					std::ostringstream outputStream;
+					exporter->exportAnimation(exporterInput, outputStream);
+					result = fmt::format(R"("result": "{}")", escapeJsonString(outputStream.str()));
+				}
+			}
+			logging::infoFormat("Finished job for file {}.", inputFilePath.u8string());
+
+			return fmt::format(
+				R"({{ "id": "{}", "type": "success", {} }})",
+				escapeJsonString(jobId.get_value_or("")),
+				result
+			);
+		} catch (...) {
+			std::throw_with_nested(
+				std::runtime_error(fmt::format("Error processing file {}.", inputFilePath.u8string()))
+			);
+		}
+	} catch (const std::exception& e) {
+		const string message = getMessage(e);
+		logging::error(message);
+		return fmt::format(
+			R"({{ "id": "{}", "type": "failure", "reason": "{}" }})",
+			escapeJsonString(jobId.get_value_or("")),
+			escapeJsonString(message)
+		);
+	}
+}
+
+void runServer(
+	std::istream& inputStream,
+	std::ostream& outputStream,
+	const JobSettings& defaultSettings,
+	int maxThreadCount
+) {
+	Server server(defaultSettings, maxThreadCount);
+	logging::info("Server ready.");
+
+	string line;
+	while (std::getline(inputStream, line)) {
+		if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+		outputStream << server.processJob(line) << std::endl;
+	}
+	logging::info("Input closed. Shutting down server.");
+}
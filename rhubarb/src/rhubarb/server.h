@@ -0,0 +1,16 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include "factories.h"
+
+// Reads jobs from the input stream until it ends, one JSON object per line. For each job, writes
+// a single-line JSON object with the result to the output stream.
+// Recognizers are created once and keep their decoders for subsequent jobs.
+// Job properties that are not specified default to the specified settings.
+void runServer(
+	std::istream& inputStream,
+	std::ostream& outputStream,
+	const JobSettings& defaultSettings,
+	int maxThreadCount
+);
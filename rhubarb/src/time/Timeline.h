@@ -1,6 +1,7 @@
 #pragma once
 #include "Timed.h"
-#include <set>
+#include <vector>
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <type_traits>
 #include "tools/tools.h"
@@ -49,10 +50,12 @@ private:
 	};
 
 public:
-	using set_type = std::set<Timed<T>, compare>;
-	using const_iterator = typename set_type::const_iterator;
+	// Elements are kept in a vector sorted by start time. Timelines are mostly built and modified
+	// in chronological order, where this beats a node-based container.
+	using vector_type = std::vector<Timed<T>>;
+	using const_iterator = typename vector_type::const_iterator;
 	using iterator = const_iterator;
-	using reverse_iterator = typename set_type::reverse_iterator;
+	using reverse_iterator = typename vector_type::const_reverse_iterator;
 	using size_type = size_t;
 	using value_type = Timed<T>;
 	using reference = const value_type&;
@@ -157,7 +160,7 @@ public:
 			case FindMode::SearchLeft:
 			{
 				// Get first element starting >= time
-				iterator it = elements.lower_bound(time);
+				iterator it = std::lower_bound(begin(), end(), time, compare());
 
 				// Go one element back
 				return it != begin() ? --it : end();
@@ -165,7 +168,7 @@ public:
 			case FindMode::SearchRight:
 			{
 				// Get first element starting > time
-				iterator it = elements.upper_bound(time);
+				iterator it = std::upper_bound(begin(), end(), time, compare());
 
 				// Go one element back
 				if (it != begin()) {
@@ -186,18 +189,7 @@ public:
 	}
 
 	virtual void clear(const TimeRange& range) {
-		// Make sure the time range is not empty
-		if (range.empty()) return;
-
-		// Split overlapping elements
-		splitAt(range.getStart());
-		splitAt(range.getEnd());
-
-		// Erase overlapping elements
-		elements.erase(
-			find(range.getStart(), FindMode::SearchRight),
-			find(range.getEnd(), FindMode::SearchRight)
-		);
+		clearRange(range);
 	}
 
 	void clear(time_type start, time_type end) {
@@ -222,11 +214,9 @@ public:
 			}
 		}
 
-		// Erase overlapping elements
-		Timeline::clear(timedValue.getTimeRange());
-
-		// Add timed value
-		return elements.insert(timedValue).first;
+		// Erase overlapping elements, then add timed value in their place
+		const auto position = clearRange(timedValue.getTimeRange());
+		return elements.insert(position, std::move(timedValue));
 	}
 
 	template<typename TElement = T>
@@ -287,12 +277,10 @@ public:
 	virtual void shift(time_type offset) {
 		if (offset == time_type::zero()) return;
 
-		set_type newElements;
-		for (Timed<T> element : elements) {
+		// Shifting all elements by the same offset doesn't affect their order
+		for (Timed<T>& element : elements) {
 			element.getTimeRange().shift(offset);
-			newElements.insert(element);
 		}
-		elements = std::move(newElements);
 	}
 
 	Timeline(const Timeline&) = default;
@@ -314,21 +302,51 @@ protected:
 	}
 
 private:
-	void splitAt(time_type splitTime) {
-		iterator elementBefore = find(splitTime - time_type(1));
-		iterator elementAfter = find(splitTime);
-		if (elementBefore != elementAfter || elementBefore == end()) return;
-		
-		Timed<T> first = *elementBefore;
-		Timed<T> second = *elementBefore;
-		elements.erase(elementBefore);
-		first.getTimeRange().resize(first.getStart(), splitTime);
-		elements.insert(first);
-		second.getTimeRange().resize(splitTime, second.getEnd());
-		elements.insert(second);
+	// Removes the specified time range, trimming or splitting partially overlapping elements.
+	// Returns the position of the resulting gap.
+	typename vector_type::iterator clearRange(const TimeRange& range) {
+		// Get first element ending after the range start
+		auto first = std::partition_point(
+			elements.begin(),
+			elements.end(),
+			[&](const Timed<T>& element) { return element.getEnd() <= range.getStart(); }
+		);
+		// Make sure the time range is not empty
+		if (range.empty()) return first;
+
+		// Get first element starting at or after the range end
+		auto last = std::lower_bound(first, elements.end(), range.getEnd(), compare());
+		if (first == last) return first;
+
+		if (std::next(first) == last
+			&& first->getStart() < range.getStart()
+			&& first->getEnd() > range.getEnd()
+		) {
+			// Split element enclosing the range
+			Timed<T> second = *first;
+			second.getTimeRange().resize(range.getEnd(), second.getEnd());
+			first->getTimeRange().resize(first->getStart(), range.getStart());
+			return elements.insert(last, std::move(second));
+		}
+
+		// Trim elements overlapping the range boundaries
+		if (first->getStart() < range.getStart()) {
+			first->getTimeRange().resize(first->getStart(), range.getStart());
+			++first;
+		}
+		if (first != last) {
+			auto& lastOverlapping = *std::prev(last);
+			if (lastOverlapping.getEnd() > range.getEnd()) {
+				lastOverlapping.getTimeRange().resize(range.getEnd(), lastOverlapping.getEnd());
+				--last;
+			}
+		}
+
+		// Erase elements within the range
+		return elements.erase(first, last);
 	}
 
-	set_type elements;
+	vector_type elements;
 };
 
 template<typename T>
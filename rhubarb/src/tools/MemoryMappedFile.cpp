@@ -0,0 +1,80 @@
+#include "MemoryMappedFile.h"
+#include "platformTools.h"
+#include <cerrno>
+#include <stdexcept>
+#include <gsl_util.h>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using std::filesystem::path;
+using std::runtime_error;
+
+MemoryMappedFile::MemoryMappedFile(const path& filePath) {
+#ifdef _WIN32
+	const HANDLE fileHandle = CreateFileW(
+		filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		throw runtime_error("Error opening file for memory mapping.");
+	}
+	auto closeFile = gsl::finally([&]() { CloseHandle(fileHandle); });
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		throw runtime_error("Error determining file size.");
+	}
+	mappedSize = static_cast<size_t>(fileSize.QuadPart);
+	if (mappedSize == 0) return;
+
+	// The view keeps the mapping alive, so we can close both handles right away
+	const HANDLE mappingHandle =
+		CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		throw runtime_error("Error creating file mapping.");
+	}
+	auto closeMapping = gsl::finally([&]() { CloseHandle(mappingHandle); });
+
+	mappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!mappedData) {
+		throw runtime_error("Error mapping file into memory.");
+	}
+#else
+	const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor == -1) {
+		throw runtime_error(errorNumberToString(errno));
+	}
+	// The mapping stays valid after the file descriptor is closed
+	auto closeFile = gsl::finally([&]() { close(fileDescriptor); });
+
+	struct stat fileStatus {};
+	if (fstat(fileDescriptor, &fileStatus) == -1) {
+		throw runtime_error(errorNumberToString(errno));
+	}
+	mappedSize = static_cast<size_t>(fileStatus.st_size);
+	if (mappedSize == 0) return;
+
+	void* address = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	if (address == MAP_FAILED) {
+		throw runtime_error(errorNumberToString(errno));
+	}
+	mappedData = static_cast<const char*>(address);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+	if (!mappedData) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(mappedData);
+#else
+	munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <filesystem>
+
+// Read-only view of an entire file, mapped into memory.
+// The mapped data can be read concurrently from multiple threads.
+class MemoryMappedFile {
+public:
+	explicit MemoryMappedFile(const std::filesystem::path& filePath);
+	MemoryMappedFile(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+	~MemoryMappedFile();
+
+	const char* data() const;
+	size_t size() const;
+
+private:
+	const char* mappedData = nullptr;
+	size_t mappedSize = 0;
+};
+
+inline const char* MemoryMappedFile::data() const {
+	return mappedData;
+}
+
+inline size_t MemoryMappedFile::size() const {
+	return mappedSize;
+}
@@ -0,0 +1,112 @@
+#include "ThreadPool.h"
+#include <stdexcept>
+#include <format.h>
+
+using std::function;
+
+// The pool and queue index of the current worker thread, if any
+thread_local ThreadPool* currentPool = nullptr;
+thread_local int currentWorkerIndex = -1;
+
+ThreadPool::ThreadPool(int threadCount) {
+	if (threadCount < 1) {
+		throw std::invalid_argument(fmt::format("Thread count cannot be {}.", threadCount));
+	}
+
+	for (int i = 0; i < threadCount; ++i) {
+		queues.push_back(std::make_unique<TaskQueue>());
+	}
+	for (int i = 0; i < threadCount; ++i) {
+		threads.emplace_back([this, i] { work(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	stateChanged.notify_all();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::schedule(function<void()> task, double priority) {
+	// Keep tasks created by a worker local to it, distribute all others
+	const bool isOwnWorker = currentPool == this;
+	const size_t queueIndex = isOwnWorker
+		? static_cast<size_t>(currentWorkerIndex)
+		: nextQueueIndex++ % queues.size();
+	{
+		TaskQueue& queue = *queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.emplace(priority, std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++queuedTaskCount;
+	}
+	stateChanged.notify_all();
+}
+
+void ThreadPool::waitUntil(const function<bool()>& condition) {
+	const bool isOwnWorker = currentPool == this;
+	while (!condition()) {
+		// Help out rather than block a worker
+		if (isOwnWorker && tryRunTask(currentWorkerIndex)) continue;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		stateChanged.wait(lock, [&] {
+			return condition() || (isOwnWorker && queuedTaskCount > 0);
+		});
+	}
+}
+
+ThreadPool* ThreadPool::getCurrent() {
+	return currentPool;
+}
+
+void ThreadPool::work(int workerIndex) {
+	currentPool = this;
+	currentWorkerIndex = workerIndex;
+
+	while (true) {
+		if (tryRunTask(workerIndex)) continue;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		stateChanged.wait(lock, [&] { return stopping || queuedTaskCount > 0; });
+		if (stopping && queuedTaskCount == 0) return;
+	}
+}
+
+bool ThreadPool::tryRunTask(int workerIndex) {
+	function<void()> task;
+
+	// Take the next task from our own queue, otherwise steal one from another queue
+	for (size_t offset = 0; !task && offset < queues.size(); ++offset) {
+		TaskQueue& queue = *queues[(workerIndex + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.begin()->second);
+			queue.tasks.erase(queue.tasks.begin());
+		}
+	}
+
+	if (!task) return false;
+
+	--queuedTaskCount;
+	runTask(task);
+	return true;
+}
+
+void ThreadPool::runTask(function<void()>& task) {
+	task();
+	task = nullptr;
+
+	// Let waiting threads re-check their conditions
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+	}
+	stateChanged.notify_all();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that execute scheduled tasks.
+// Each worker has its own task queue. Tasks scheduled from within a worker go to its own queue;
+// idle workers steal tasks from the queues of others. Within a queue, tasks with higher priority
+// run first; tasks with equal priority run in the order they were scheduled.
+class ThreadPool {
+public:
+	explicit ThreadPool(int threadCount);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int getThreadCount() const {
+		return static_cast<int>(threads.size());
+	}
+
+	// Schedules a task for execution. Tasks must not throw.
+	void schedule(std::function<void()> task, double priority = 0.0);
+
+	// Blocks until the condition is met. The condition is checked whenever a task has finished.
+	// When called from a worker, the worker executes pending tasks in the meantime.
+	void waitUntil(const std::function<bool()>& condition);
+
+	// Returns the pool the calling thread is a worker of, or nullptr
+	static ThreadPool* getCurrent();
+
+private:
+	struct TaskQueue {
+		std::mutex mutex;
+		std::multimap<double, std::function<void()>, std::greater<double>> tasks;
+	};
+
+	void work(int workerIndex);
+	bool tryRunTask(int workerIndex);
+	void runTask(std::function<void()>& task);
+
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable stateChanged;
+	// Number of tasks in all queues. Only incremented while holding the mutex.
+	std::atomic<int> queuedTaskCount { 0 };
+	std::atomic<unsigned> nextQueueIndex { 0 };
+	bool stopping = false;
+};
@@ -1,85 +1,126 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
-#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include "progress.h"
-#include <gsl_util.h>
+#include "ThreadPool.h"
+#include <format.h>
 
+inline int getProcessorCoreCount() {
+	const int coreCount = std::thread::hardware_concurrency();
+
+	// If the number of cores cannot be determined, use a reasonable default
+	return coreCount != 0 ? coreCount : 4;
+}
+
+// Returns a process-wide thread pool for parallel work outside of other thread pools.
+// It is created on first use, with one thread per processor core or the specified number of
+// threads, whichever is higher.
+inline ThreadPool& getSharedThreadPool(int minThreadCount) {
+	static ThreadPool threadPool(std::max(getProcessorCoreCount(), minThreadCount));
+	return threadPool;
+}
+
+// Processes all elements using the specified thread pool and waits for them to finish.
+// At most maxThreadCount elements are processed at the same time. Elements with higher priority
+// are started first; if maxThreadCount is 1, elements are processed in order on the calling thread.
+// Re-throws the first exception thrown while processing an element. After a failure, elements
+// that haven't been started yet are skipped.
 template<typename TCollection>
 void runParallel(
+	ThreadPool& threadPool,
 	std::function<void(typename TCollection::reference)> processElement,
 	TCollection& collection,
-	int maxThreadCount)
+	int maxThreadCount = std::numeric_limits<int>::max(),
+	std::function<double(typename TCollection::reference)> getElementPriority =
+		[](typename TCollection::reference) { return 0.0; })
 {
 	if (maxThreadCount < 1) {
 		throw std::invalid_argument(fmt::format("maxThreadCount cannot be {}.", maxThreadCount));
 	}
 
 	if (maxThreadCount == 1) {
-		// Process synchronously
+		// Process synchronously, in the original order
 		for (auto& element : collection) {
 			processElement(element);
 		}
 		return;
 	}
 
-	using future_type = std::future<void>;
-
-	std::mutex mutex;
-	int currentThreadCount = 0;
-	std::condition_variable elementFinished;
-	future_type finishedElement;
-
-	// Before exiting, wait for all running tasks to finish, but don't re-throw exceptions.
-	// This only applies if one task already failed with an exception.
-	auto finishRunning = gsl::finally([&] {
-		std::unique_lock<std::mutex> lock(mutex);
-		elementFinished.wait(lock, [&] { return currentThreadCount == 0; });
+	// Order elements by descending priority
+	using element_pointer = std::remove_reference_t<typename TCollection::reference>*;
+	std::vector<std::pair<double, element_pointer>> elements;
+	for (auto& element : collection) {
+		elements.emplace_back(getElementPriority(element), &element);
+	}
+	std::stable_sort(elements.begin(), elements.end(), [](const auto& a, const auto& b) {
+		return a.first > b.first;
 	});
 
-	// Asynchronously run all elements
-	for (auto it = collection.begin(); it != collection.end(); ++it) {
-		// This variable will later hold the future, but can be value-captured right now
-		auto future = std::make_shared<future_type>();
-
-		// Notifies that an element is done processing
-		auto notifyElementDone = [&, future] {
-			std::lock_guard<std::mutex> lock(mutex);
-			finishedElement = std::move(*future);
-			--currentThreadCount;
-			elementFinished.notify_one();
-		};
-
-		// Processes the current element, then notifies
-		auto wrapperFunction = [processElement, &element = *it, notifyElementDone]() {
-			auto done = gsl::finally(notifyElementDone);
-			processElement(element);
-		};
-
-		// Asynchronously process element
-		{
-			std::lock_guard<std::mutex> lock(mutex);
-			*future = std::async(std::launch::async, wrapperFunction);
-			++currentThreadCount;
-		}
-
-		// Wait for threads to finish, if necessary
-		{
-			std::unique_lock<std::mutex> lock(mutex);
-			const int targetThreadCount = it == collection.end() ? 0 : maxThreadCount - 1;
-			while (currentThreadCount > targetThreadCount) {
-				elementFinished.wait(lock);
-				if (finishedElement.valid()) {
-					// Re-throw any exception
-					finishedElement.get();
-					finishedElement = future_type();
+	// Each runner task keeps processing the next element until none are left
+	const int runnerCount = static_cast<int>(
+		std::min<size_t>(static_cast<size_t>(maxThreadCount), elements.size())
+	);
+	std::atomic<size_t> nextElementIndex(0);
+	std::atomic<int> remainingRunnerCount(runnerCount);
+	std::atomic<bool> failed(false);
+	std::exception_ptr exception;
+	const auto runElements = [&] {
+		for (
+			size_t index = nextElementIndex++;
+			index < elements.size() && !failed;
+			index = nextElementIndex++
+		) {
+			try {
+				processElement(*elements[index].second);
+			} catch (...) {
+				if (!failed.exchange(true)) {
+					exception = std::current_exception();
 				}
 			}
 		}
+		--remainingRunnerCount;
+	};
+	for (int runnerIndex = 0; runnerIndex < runnerCount; ++runnerIndex) {
+		threadPool.schedule(runElements, elements[runnerIndex].first);
+	}
+
+	threadPool.waitUntil([&] { return remainingRunnerCount == 0; });
+	if (exception) {
+		std::rethrow_exception(exception);
 	}
+}
 
+// Processes all elements in parallel. Within a thread pool, shares its workers; otherwise, uses the
+// shared thread pool.
+// At most maxThreadCount elements are processed at the same time. Elements with higher priority
+// are started first.
+template<typename TCollection>
+void runParallel(
+	std::function<void(typename TCollection::reference)> processElement,
+	TCollection& collection,
+	int maxThreadCount,
+	std::function<double(typename TCollection::reference)> getElementPriority =
+		[](typename TCollection::reference) { return 0.0; })
+{
+	ThreadPool* currentThreadPool = ThreadPool::getCurrent();
+	runParallel(
+		currentThreadPool ? *currentThreadPool : getSharedThreadPool(maxThreadCount),
+		processElement,
+		collection,
+		maxThreadCount,
+		getElementPriority
+	);
 }
 
+// Like runParallel above, with progress reporting.
+// The progress weight of each element also serves as its priority.
 template<typename TCollection>
 void runParallel(
 	const std::string& description,
@@ -92,25 +133,142 @@ void runParallel(
 {
 	// Create a collection of wrapper functions that take care of progress handling
 	ProgressMerger progressMerger(progressSink);
-	std::vector<std::function<void()>> functions;
+	using Task = std::pair<std::function<void()>, double>;
+	std::vector<Task> tasks;
 	int elementIndex = 0;
 	for (auto& element : collection) {
+		const double weight = getElementProgressWeight(element);
 		auto& elementProgressSink = progressMerger.addSource(
 			fmt::format("runParallel ({}) #{}", description, elementIndex),
-			getElementProgressWeight(element)
+			weight
 		);
-		functions.push_back([&]() { processElement(element, elementProgressSink); });
+		tasks.emplace_back([&]() { processElement(element, elementProgressSink); }, weight);
 
 		++elementIndex;
 	}
 
-	// Run wrapper function
-	runParallel([&](std::function<void()> function) { function(); }, functions, maxThreadCount);
+	// Run wrapper functions
+	runParallel(
+		[](Task& task) { task.first(); },
+		tasks,
+		maxThreadCount,
+		[](Task& task) { return task.second; }
+	);
 }
 
-inline int getProcessorCoreCount() {
-	const int coreCount = std::thread::hardware_concurrency();
+// Processes elements in parallel while more elements are still being added.
+// At most maxThreadCount elements are processed at the same time, starting in the order they were
+// added. If maxThreadCount is 1, each element is processed on the calling thread as it is added.
+// After an element has failed, the remaining elements are skipped.
+template<typename T>
+class ParallelQueue {
+public:
+	ParallelQueue(
+		ThreadPool& threadPool,
+		std::function<void(T&)> processElement,
+		int maxThreadCount,
+		double priority = 0.0
+	) :
+		threadPool(threadPool),
+		processElement(std::move(processElement)),
+		maxThreadCount(maxThreadCount),
+		priority(priority)
+	{
+		if (maxThreadCount < 1) {
+			throw std::invalid_argument(fmt::format("maxThreadCount cannot be {}.", maxThreadCount));
+		}
+	}
 
-	// If the number of cores cannot be determined, use a reasonable default
-	return coreCount != 0 ? coreCount : 4;
-}
+	// Within a thread pool, shares its workers; otherwise, uses the shared thread pool.
+	ParallelQueue(std::function<void(T&)> processElement, int maxThreadCount) :
+		ParallelQueue(
+			ThreadPool::getCurrent() ? *ThreadPool::getCurrent() : getSharedThreadPool(maxThreadCount),
+			std::move(processElement),
+			maxThreadCount
+		)
+	{}
+
+	// Waits for elements that are being processed. Skips the others unless finish() was called.
+	~ParallelQueue() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pendingElements.clear();
+		}
+		waitForTasks();
+	}
+
+	ParallelQueue(const ParallelQueue&) = delete;
+	ParallelQueue& operator=(const ParallelQueue&) = delete;
+
+	void add(T element) {
+		if (maxThreadCount == 1) {
+			if (!exception) {
+				process(element);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (exception) return;
+
+		pendingElements.push_back(std::move(element));
+		if (runningCount < maxThreadCount) {
+			++runningCount;
+			threadPool.schedule([this] { runNext(); }, priority);
+		}
+	}
+
+	// Waits until all elements have been processed. Re-throws the first exception thrown while
+	// processing an element.
+	void finish() {
+		waitForTasks();
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+
+private:
+	void waitForTasks() {
+		threadPool.waitUntil([this] { return runningCount == 0; });
+		// The last task may still hold the mutex
+		std::lock_guard<std::mutex> lock(mutex);
+	}
+
+	void process(T& element) {
+		try {
+			processElement(element);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!exception) {
+				exception = std::current_exception();
+				pendingElements.clear();
+			}
+		}
+	}
+
+	// Processes the next element, then schedules another task for the element after it. This
+	// allows tasks with higher priority to run in between.
+	void runNext() {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (pendingElements.empty()) {
+			--runningCount;
+			return;
+		}
+		T element = std::move(pendingElements.front());
+		pendingElements.pop_front();
+		lock.unlock();
+
+		process(element);
+		threadPool.schedule([this] { runNext(); }, priority);
+	}
+
+	ThreadPool& threadPool;
+	const std::function<void(T&)> processElement;
+	const int maxThreadCount;
+	const double priority;
+	std::mutex mutex;
+	std::deque<T> pendingElements;
+	// Number of scheduled tasks. Only changed while holding the mutex.
+	std::atomic<int> runningCount { 0 };
+	std::exception_ptr exception;
+};
@@ -13,6 +13,8 @@
 
 #ifdef _WIN32
 	#include <Windows.h>
+	#include <io.h>
+	#include <fcntl.h>
 #endif
 #include "fileTools.h"
 
@@ -100,14 +102,24 @@ std::tm getLocalTime(const time_t& time) {
 	return timeInfo;
 }
 
+// The XSI variant of strerror_r fills the buffer, while the GNU variant may instead return a
+// pointer to a static message. These overloads handle both.
+inline const char* getStrerrorMessage(int, const char* buffer) {
+	return buffer;
+}
+
+inline const char* getStrerrorMessage(const char* message, const char*) {
+	return message;
+}
+
 std::string errorNumberToString(int errorNumber) {
-	char message[256];
+	char message[256] = {};
 #if (__unix || __linux || __APPLE__)
-	strerror_r(errorNumber, message, sizeof message);
+	return getStrerrorMessage(strerror_r(errorNumber, message, sizeof message), message);
 #else
 	strerror_s(message, sizeof message, errorNumber);
-#endif
 	return message;
+#endif
 }
 
 vector<string> argsToUtf8(int argc, char* argv[]) {
@@ -174,3 +186,11 @@ void useUtf8ForConsole() {
 	std::cerr.rdbuf(new ConsoleBuffer(stderr));
 #endif
 }
+
+void useBinaryModeForStdin() {
+	// Unix systems don't distinguish between text and binary streams
+#ifdef _WIN32
+	// Prevent newline conversion, which would corrupt binary data
+	_setmode(_fileno(stdin), _O_BINARY);
+#endif
+}
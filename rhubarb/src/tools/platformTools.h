@@ -15,3 +15,5 @@ std::string errorNumberToString(int errorNumber);
 std::vector<std::string> argsToUtf8(int argc, char* argv[]);
 
 void useUtf8ForConsole();
+
+void useBinaryModeForStdin();
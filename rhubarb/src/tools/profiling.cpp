@@ -0,0 +1,245 @@
+#include "profiling.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <format.h>
+#include "TablePrinter.h"
+#include "stringTools.h"
+
+using std::string;
+using std::vector;
+using std::map;
+using std::shared_ptr;
+using std::make_shared;
+using std::ostream;
+using std::chrono::duration;
+
+namespace profiling {
+
+	namespace {
+
+		struct ThreadBuffer {
+			explicit ThreadBuffer(int threadIndex) :
+				threadIndex(threadIndex)
+			{}
+
+			const int threadIndex;
+			// Only contended while the results are read
+			std::mutex mutex;
+			vector<Event> events;
+			map<string, int64_t, std::less<>> counters;
+		};
+
+		struct Registry {
+			std::mutex mutex;
+			vector<shared_ptr<ThreadBuffer>> buffers;
+			clock::time_point startTime;
+		};
+
+		std::atomic<bool> enabled { false };
+
+		Registry& getRegistry() {
+			static Registry registry;
+			return registry;
+		}
+
+		ThreadBuffer& getThreadBuffer() {
+			// The registry keeps the buffer alive after the thread has ended
+			thread_local const shared_ptr<ThreadBuffer> buffer = [] {
+				Registry& registry = getRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				auto result = make_shared<ThreadBuffer>(static_cast<int>(registry.buffers.size()));
+				registry.buffers.push_back(result);
+				return result;
+			}();
+			return *buffer;
+		}
+
+		clock::time_point getStartTime() {
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			return registry.startTime;
+		}
+
+		// Requires the buffer's mutex to be locked
+		void addToCounter(ThreadBuffer& buffer, const char* name, int64_t value) {
+			const auto it = buffer.counters.find(name);
+			if (it != buffer.counters.end()) {
+				it->second += value;
+			} else {
+				buffer.counters.emplace(name, value);
+			}
+		}
+
+		double toMilliseconds(clock::duration value) {
+			return duration<double, std::milli>(value).count();
+		}
+
+		string formatMilliseconds(clock::duration value) {
+			return fmt::format("{:.1f} ms", toMilliseconds(value));
+		}
+
+	}
+
+	void enable() {
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (const auto& buffer : registry.buffers) {
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			buffer->events.clear();
+			buffer->counters.clear();
+		}
+		registry.startTime = clock::now();
+		enabled = true;
+	}
+
+	bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	ScopedTimer::ScopedTimer(const char* name, string detail) :
+		name(name),
+		detail(std::move(detail)),
+		active(isEnabled()),
+		start(active ? clock::now() : clock::time_point())
+	{}
+
+	ScopedTimer::~ScopedTimer() {
+		if (!active) return;
+
+		const clock::duration duration = clock::now() - start;
+		ThreadBuffer& buffer = getThreadBuffer();
+		std::lock_guard<std::mutex> lock(buffer.mutex);
+		if (buffer.events.size() < maxEventsPerThread) {
+			buffer.events.push_back({ name, std::move(detail), buffer.threadIndex, start, duration });
+		} else {
+			addToCounter(buffer, "dropped events", 1);
+		}
+	}
+
+	void count(const char* name, int64_t value) {
+		if (!isEnabled()) return;
+
+		ThreadBuffer& buffer = getThreadBuffer();
+		std::lock_guard<std::mutex> lock(buffer.mutex);
+		addToCounter(buffer, name, value);
+	}
+
+	vector<Event> getEvents() {
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		vector<Event> result;
+		for (const auto& buffer : registry.buffers) {
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			result.insert(result.end(), buffer->events.begin(), buffer->events.end());
+		}
+		std::stable_sort(result.begin(), result.end(), [](const Event& a, const Event& b) {
+			return a.start < b.start;
+		});
+		return result;
+	}
+
+	map<string, int64_t> getCounters() {
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		map<string, int64_t> result;
+		for (const auto& buffer : registry.buffers) {
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			for (const auto& counter : buffer->counters) {
+				result[counter.first] += counter.second;
+			}
+		}
+		return result;
+	}
+
+	void printSummary(ostream& stream) {
+		struct Stage {
+			string name;
+			int callCount = 0;
+			clock::duration total = clock::duration::zero();
+			clock::duration max = clock::duration::zero();
+		};
+
+		// List stages in the order they were first entered
+		vector<Stage> stages;
+		std::unordered_map<string, size_t> stageIndices;
+		clock::time_point end = getStartTime();
+		for (const Event& event : getEvents()) {
+			const auto it = stageIndices.emplace(event.name, stages.size()).first;
+			if (it->second == stages.size()) {
+				stages.push_back(Stage { event.name });
+			}
+			Stage& stage = stages[it->second];
+			++stage.callCount;
+			stage.total += event.duration;
+			stage.max = std::max(stage.max, event.duration);
+			end = std::max(end, event.start + event.duration);
+		}
+
+		const TablePrinter tablePrinter(&stream, { 24, 7, 12, 12, 12 });
+		tablePrinter.printRow({ "Stage", "Calls", "Total", "Mean", "Max" });
+		for (const Stage& stage : stages) {
+			tablePrinter.printRow({
+				stage.name,
+				std::to_string(stage.callCount),
+				formatMilliseconds(stage.total),
+				formatMilliseconds(stage.total / stage.callCount),
+				formatMilliseconds(stage.max)
+			});
+		}
+		stream << fmt::format("Wall time: {}", formatMilliseconds(end - getStartTime())) << std::endl;
+
+		const map<string, int64_t> counters = getCounters();
+		if (!counters.empty()) {
+			stream << std::endl;
+			const TablePrinter counterPrinter(&stream, { 24, 12 });
+			counterPrinter.printRow({ "Counter", "Value" });
+			for (const auto& counter : counters) {
+				counterPrinter.printRow({ counter.first, std::to_string(counter.second) });
+			}
+		}
+	}
+
+	void writeChromeTrace(ostream& stream) {
+		const clock::time_point startTime = getStartTime();
+		const auto toMicroseconds = [](clock::duration value) {
+			return duration<double, std::micro>(value).count();
+		};
+
+		stream << "{\n";
+		stream << "  \"displayTimeUnit\": \"ms\",\n";
+		stream << "  \"traceEvents\": [";
+		bool isFirst = true;
+		for (const Event& event : getEvents()) {
+			stream << (isFirst ? "\n" : ",\n");
+			isFirst = false;
+			stream << fmt::format(
+				"    {{ \"name\": \"{}\", \"cat\": \"rhubarb\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, "
+				"\"ts\": {:.3f}, \"dur\": {:.3f}",
+				escapeJsonString(event.name),
+				event.threadIndex,
+				toMicroseconds(event.start - startTime),
+				toMicroseconds(event.duration)
+			);
+			if (!event.detail.empty()) {
+				stream << fmt::format(", \"args\": {{ \"detail\": \"{}\" }}", escapeJsonString(event.detail));
+			}
+			stream << " }";
+		}
+		stream << "\n  ],\n";
+
+		// Counters are totals, so they go into the metadata rather than onto the timeline
+		stream << "  \"otherData\": {";
+		isFirst = true;
+		for (const auto& counter : getCounters()) {
+			stream << (isFirst ? "\n" : ",\n");
+			isFirst = false;
+			stream << fmt::format("    \"{}\": {}", escapeJsonString(counter.first), counter.second);
+		}
+		stream << "\n  }\n";
+		stream << "}\n";
+	}
+
+}
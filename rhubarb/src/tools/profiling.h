@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Lightweight instrumentation for finding out where processing time goes.
+// Timers and counters are recorded into per-thread buffers, so threads don't contend while
+// recording. Recording is disabled by default, in which case timers and counters do nothing
+// but check a flag.
+namespace profiling {
+
+	using clock = std::chrono::steady_clock;
+
+	// Starts recording. Events and counters before this call are lost.
+	void enable();
+
+	bool isEnabled();
+
+	// Events beyond this number per thread are dropped and counted as "dropped events", so
+	// long-running processes such as the server don't grow without bounds
+	constexpr size_t maxEventsPerThread = 100000;
+
+	// Records the lifetime of the timer as an event of the current thread
+	class ScopedTimer {
+	public:
+		// The name must outlive all profiling data, so use a string literal. The optional detail
+		// distinguishes events of the same name, such as individual utterances.
+		explicit ScopedTimer(const char* name, std::string detail = std::string());
+
+		// Only calls the function to get the detail if recording is enabled
+		template<
+			typename GetDetail,
+			typename = std::enable_if_t<std::is_invocable_r_v<std::string, GetDetail>>
+		>
+		ScopedTimer(const char* name, GetDetail getDetail) :
+			ScopedTimer(name)
+		{
+			if (active) detail = getDetail();
+		}
+
+		~ScopedTimer();
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		const char* name;
+		std::string detail;
+		bool active;
+		clock::time_point start;
+	};
+
+	// Adds the value to the named counter. The name must outlive all profiling data.
+	void count(const char* name, int64_t value = 1);
+
+	struct Event {
+		const char* name;
+		std::string detail;
+		// Threads are numbered in the order they recorded their first event or counter
+		int threadIndex;
+		clock::time_point start;
+		clock::duration duration;
+	};
+
+	// Returns the events of all threads, ordered by start time
+	std::vector<Event> getEvents();
+
+	// Returns the counters, summed over all threads
+	std::map<std::string, int64_t> getCounters();
+
+	// Prints a table with calls and times per event name, followed by the counters
+	void printSummary(std::ostream& stream);
+
+	// Writes all events and counters in Chrome's trace event format.
+	// The file can be viewed in chrome://tracing or in Perfetto.
+	void writeChromeTrace(std::ostream& stream);
+
+}
@@ -0,0 +1,134 @@
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include "recognition/CachingRecognizer.h"
+#include "audio/MemoryAudioClip.h"
+
+using namespace testing;
+using std::string;
+using std::vector;
+using std::unique_ptr;
+using std::make_shared;
+using std::filesystem::path;
+using boost::optional;
+
+// Returns the same phones for any input, counting the calls
+class FakeRecognizer : public Recognizer {
+public:
+	explicit FakeRecognizer(int& callCount) :
+		callCount(callCount)
+	{}
+
+	BoundedTimeline<Phone> recognizePhones(
+		const AudioClip& audioClip,
+		optional<string> dialog,
+		int maxThreadCount,
+		ProgressSink& progressSink
+	) const override {
+		UNUSED(dialog);
+		UNUSED(maxThreadCount);
+		UNUSED(progressSink);
+		++callCount;
+		BoundedTimeline<Phone> phones(audioClip.getTruncatedRange());
+		phones.set(10_cs, 20_cs, Phone::AA);
+		phones.set(25_cs, 40_cs, Phone::Noise);
+		return phones;
+	}
+
+	unique_ptr<PhoneStream> createPhoneStream(int, optional<string>, centiseconds) const override {
+		throw std::logic_error("Not implemented.");
+	}
+
+private:
+	int& callCount;
+};
+
+MemoryAudioClip createClip(int16_t value) {
+	return MemoryAudioClip(make_shared<vector<int16_t>>(16000, value), 16000);
+}
+
+class CachingRecognizerTest : public Test {
+protected:
+	CachingRecognizerTest() :
+		cacheDirectory(
+			std::filesystem::temp_directory_path()
+			/ (string("rhubarb-cache-test-") + UnitTest::GetInstance()->current_test_info()->name())
+		)
+	{
+		std::filesystem::remove_all(cacheDirectory);
+	}
+
+	~CachingRecognizerTest() override {
+		std::filesystem::remove_all(cacheDirectory);
+	}
+
+	CachingRecognizer createRecognizer(const string& recognizerKey) {
+		return CachingRecognizer(std::make_unique<FakeRecognizer>(callCount), recognizerKey, cacheDirectory);
+	}
+
+	path cacheDirectory;
+	int callCount = 0;
+	NullProgressSink progressSink;
+};
+
+TEST_F(CachingRecognizerTest, returnsCachedPhonesForSameInput) {
+	const BoundedTimeline<Phone> phones =
+		createRecognizer("key").recognizePhones(createClip(100), string("dialog"), 1, progressSink);
+	const BoundedTimeline<Phone> cachedPhones =
+		createRecognizer("key").recognizePhones(createClip(100), string("dialog"), 1, progressSink);
+	EXPECT_EQ(callCount, 1);
+	EXPECT_EQ(cachedPhones, phones);
+	EXPECT_EQ(cachedPhones.getRange(), phones.getRange());
+}
+
+TEST_F(CachingRecognizerTest, recognizesAgainIfInputDiffers) {
+	createRecognizer("key").recognizePhones(createClip(100), string("dialog"), 1, progressSink);
+	createRecognizer("key").recognizePhones(createClip(101), string("dialog"), 1, progressSink);
+	createRecognizer("key").recognizePhones(createClip(100), string("other dialog"), 1, progressSink);
+	createRecognizer("key").recognizePhones(createClip(100), boost::none, 1, progressSink);
+	createRecognizer("other key").recognizePhones(createClip(100), string("dialog"), 1, progressSink);
+	EXPECT_EQ(callCount, 5);
+}
+
+TEST_F(CachingRecognizerTest, ignoresCorruptCacheFiles) {
+	createRecognizer("key").recognizePhones(createClip(100), boost::none, 1, progressSink);
+	for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) {
+		std::ofstream(entry.path(), std::ios::binary) << "garbage";
+	}
+	createRecognizer("key").recognizePhones(createClip(100), boost::none, 1, progressSink);
+	EXPECT_EQ(callCount, 2);
+}
+
+TEST(writePhones, roundTrips) {
+	BoundedTimeline<Phone> phones(TimeRange(0_cs, 500_cs));
+	phones.set(3_cs, 7_cs, Phone::B);
+	phones.set(7_cs, 100_cs, Phone::Schwa);
+	phones.set(250_cs, 499_cs, Phone::Breath);
+
+	std::stringstream stream;
+	writePhones(phones, stream);
+	const BoundedTimeline<Phone> result = readPhones(stream);
+	EXPECT_EQ(result.getRange(), phones.getRange());
+	EXPECT_EQ(result, phones);
+}
+
+TEST(readPhones, rejectsNegativeTimes) {
+	BoundedTimeline<Phone> phones(TimeRange(0_cs, 500_cs));
+	phones.set(10_cs, 20_cs, Phone::B);
+	std::stringstream validStream;
+	writePhones(phones, validStream);
+	const string valid = validStream.str();
+
+	// Header: magic, version, range start, range end, phone count. Then per phone: offset, duration.
+	const size_t offsetPosition = 20;
+	for (size_t position : { offsetPosition, offsetPosition + 4 }) {
+		SCOPED_TRACE(position);
+		string corrupt = valid;
+		corrupt.replace(position, 4, string("\xfb\xff\xff\xff", 4)); // -5 in little-endian
+		std::stringstream stream(corrupt);
+		EXPECT_THAT(
+			[&] { readPhones(stream); },
+			ThrowsMessage<std::runtime_error>(HasSubstr("Invalid timing for phone 0"))
+		);
+	}
+}
@@ -0,0 +1,44 @@
+#include <gmock/gmock.h>
+#include "audio/MemoryAudioClip.h"
+#include <limits>
+
+using namespace testing;
+using std::vector;
+using std::make_shared;
+
+// Clip of one second at 100 Hz, so that each sample corresponds to one centisecond
+MemoryAudioClip createRampClip() {
+	const auto samples = make_shared<vector<int16_t>>();
+	for (int16_t i = 0; i < 100; ++i) {
+		samples->push_back(i);
+	}
+	return MemoryAudioClip(samples, 100);
+}
+
+TEST(MemoryAudioClip, getSegment) {
+	const MemoryAudioClip clip = createRampClip();
+	const MemoryAudioClip segment = clip.getSegment(TimeRange(10_cs, 30_cs));
+	EXPECT_EQ(segment.size(), 20);
+	EXPECT_THAT(segment.getSamples()[0], Eq(10));
+	EXPECT_THAT(segment.getSamples()[19], Eq(29));
+
+	const MemoryAudioClip nestedSegment = segment.getSegment(TimeRange(5_cs, 6_cs));
+	EXPECT_EQ(nestedSegment.size(), 1);
+	EXPECT_THAT(nestedSegment.getSamples()[0], Eq(15));
+
+	EXPECT_EQ(clip.getSegment(TimeRange(100_cs, 100_cs)).size(), 0);
+}
+
+TEST(MemoryAudioClip, getSegmentThrowsBeyondClip) {
+	const MemoryAudioClip clip = createRampClip();
+	EXPECT_THROW(clip.getSegment(TimeRange(-1_cs, 10_cs)), std::invalid_argument);
+	EXPECT_THROW(clip.getSegment(TimeRange(90_cs, 101_cs)), std::invalid_argument);
+	EXPECT_THROW(clip.getSegment(TimeRange(0_cs, 10_cs)).getSegment(TimeRange(5_cs, 11_cs)), std::invalid_argument);
+}
+
+TEST(MemoryAudioClip, getSegmentThrowsOnOverflowingRange) {
+	// Converted to samples naively, this duration would overflow into a negative count
+	const MemoryAudioClip clip = createRampClip();
+	const centiseconds tooLong(std::numeric_limits<centiseconds::rep>::max() / 2);
+	EXPECT_THROW(clip.getSegment(TimeRange(0_cs, tooLong)), std::invalid_argument);
+}
@@ -0,0 +1,71 @@
+#include <gmock/gmock.h>
+#include <fstream>
+#include <gsl_util.h>
+#include "recognition/PronunciationDictionary.h"
+#include "tools/platformTools.h"
+
+using namespace testing;
+using std::string;
+using std::vector;
+using std::filesystem::path;
+
+// Writes the text to a temporary file, deleting it when the result goes out of scope
+auto createTempFile(const string& text, path& filePath) {
+	filePath = getTempFilePath();
+	std::ofstream(filePath, std::ios::binary) << text;
+	return gsl::finally([filePath]() { std::filesystem::remove(filePath); });
+}
+
+vector<string> getPhones(const PronunciationDictionary& dictionary, const string& word) {
+	vector<string> result;
+	for (uint8_t phoneIndex : dictionary.getPronunciation(*dictionary.find(word))) {
+		result.push_back(dictionary.getPhoneNames().at(phoneIndex));
+	}
+	return result;
+}
+
+TEST(PronunciationDictionary, compilesTextDictionary) {
+	path textFilePath;
+	const auto deleteTextFile = createTempFile(
+		";; comment\n"
+		"read R IY D\n"
+		"lip L IH P\n"
+		"read(2) R EH D\n"
+		"read L EH D\n" // duplicate
+		"sync(2) S IH NG K\n" // no base word
+		"orphan\n" // no pronunciation
+		"\n"
+		"rhubarb\tR UW B AA R B\r\n",
+		textFilePath
+	);
+	const path binaryFilePath = getTempFilePath();
+	auto deleteBinaryFile = gsl::finally([&]() { std::filesystem::remove(binaryFilePath); });
+
+	PronunciationDictionary::compile(textFilePath, binaryFilePath);
+	const PronunciationDictionary dictionary(binaryFilePath);
+
+	ASSERT_EQ(dictionary.getEntryCount(), 4);
+	EXPECT_EQ(dictionary.getWord(0), "read");
+	EXPECT_EQ(dictionary.getWord(1), "lip");
+	EXPECT_EQ(dictionary.getWord(2), "read(2)");
+	EXPECT_EQ(dictionary.getWord(3), "rhubarb");
+	EXPECT_EQ(dictionary.getBaseEntryIndex(2), 0);
+	EXPECT_EQ(dictionary.getBaseEntryIndex(3), 3);
+
+	ASSERT_TRUE(dictionary.contains("lip"));
+	EXPECT_EQ(*dictionary.find("lip"), 1);
+	EXPECT_FALSE(dictionary.contains("sync(2)"));
+	EXPECT_FALSE(dictionary.contains("orphan"));
+	EXPECT_FALSE(dictionary.contains("Lip"));
+	EXPECT_FALSE(dictionary.contains(""));
+
+	EXPECT_THAT(getPhones(dictionary, "read"), ElementsAre("R", "IY", "D"));
+	EXPECT_THAT(getPhones(dictionary, "read(2)"), ElementsAre("R", "EH", "D"));
+	EXPECT_THAT(getPhones(dictionary, "rhubarb"), ElementsAre("R", "UW", "B", "AA", "R", "B"));
+}
+
+TEST(PronunciationDictionary, rejectsInvalidFiles) {
+	path filePath;
+	const auto deleteFile = createTempFile("read R IY D\n", filePath);
+	EXPECT_THROW(PronunciationDictionary dictionary(filePath), std::runtime_error);
+}
@@ -0,0 +1,146 @@
+#include <gmock/gmock.h>
+#include <cmath>
+#include "audio/SampleRateConverter.h"
+
+using namespace testing;
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+constexpr double pi = 3.14159265358979323846;
+
+// Synthetic clip containing a sine wave
+class SineClip : public AudioClip {
+public:
+	SineClip(int sampleRate, double frequency, size_type size) :
+		sampleRate(sampleRate),
+		frequency(frequency),
+		sampleCount(size)
+	{}
+	unique_ptr<AudioClip> clone() const override { return make_unique<SineClip>(*this); }
+	int getSampleRate() const override { return sampleRate; }
+	size_type size() const override { return sampleCount; }
+
+private:
+	SampleReader createUnsafeSampleReader() const override {
+		return [*this](size_type index) { return getSample(index); };
+	}
+	void readUnsafeBlock(size_type start, gsl::span<value_type> out) const override {
+		for (size_type i = 0; i < static_cast<size_type>(out.size()); ++i) {
+			out[i] = getSample(start + i);
+		}
+	}
+	value_type getSample(size_type index) const {
+		return static_cast<value_type>(0.5 * std::sin(2 * pi * frequency * index / sampleRate));
+	}
+
+	int sampleRate;
+	double frequency;
+	size_type sampleCount;
+};
+
+vector<float> resampleSine(int inputSampleRate, double frequency, int outputSampleRate) {
+	const unique_ptr<AudioClip> clip =
+		make_unique<SineClip>(inputSampleRate, frequency, inputSampleRate)
+		| resample(outputSampleRate);
+	vector<float> result(static_cast<size_t>(clip->size()));
+	clip->readBlock(0, result);
+	return result;
+}
+
+// Returns the RMS value of the samples, ignoring the edges
+double getRms(const vector<float>& samples) {
+	const size_t margin = samples.size() / 10;
+	double sum = 0;
+	for (size_t i = margin; i < samples.size() - margin; ++i) {
+		sum += samples[i] * samples[i];
+	}
+	return std::sqrt(sum / (samples.size() - 2 * margin));
+}
+
+TEST(SampleRateConverter, size) {
+	EXPECT_EQ(resampleSine(48000, 1000, 16000).size(), 16000u);
+	EXPECT_EQ(resampleSine(44100, 1000, 16000).size(), 16000u);
+	EXPECT_EQ(resampleSine(8000, 1000, 16000).size(), 16000u);
+}
+
+TEST(SampleRateConverter, preservesPassband) {
+	const double expectedRms = 0.5 / std::sqrt(2.0);
+	for (int inputSampleRate : { 48000, 44100, 22050, 8000 }) {
+		SCOPED_TRACE(inputSampleRate);
+		const vector<float> samples = resampleSine(inputSampleRate, 1000, 16000);
+		EXPECT_NEAR(getRms(samples), expectedRms, 0.01);
+
+		// The resampled signal is in phase with the original one
+		for (size_t i = 1000; i < 1100; ++i) {
+			EXPECT_NEAR(samples[i], 0.5 * std::sin(2 * pi * 1000 * i / 16000), 0.01);
+		}
+	}
+}
+
+TEST(SampleRateConverter, suppressesAliasing) {
+	// Frequencies above the output Nyquist frequency must not fold back into the passband
+	for (int inputSampleRate : { 48000, 44100 }) {
+		SCOPED_TRACE(inputSampleRate);
+		EXPECT_LT(getRms(resampleSine(inputSampleRate, 11000, 16000)), 0.001);
+		EXPECT_LT(getRms(resampleSine(inputSampleRate, 5000, 8000)), 0.001);
+	}
+}
+
+TEST(SampleRateConverter, readBlockMatchesSampleReader) {
+	const unique_ptr<AudioClip> clip =
+		make_unique<SineClip>(44100, 440, 44100) | resample(16000);
+	vector<float> block(500);
+	clip->readBlock(3000, block);
+	const auto read = clip->createSampleReader();
+	for (size_t i = 0; i < block.size(); ++i) {
+		EXPECT_EQ(block[i], read(3000 + i));
+	}
+}
+
+TEST(SampleRateConverter, preservesSamplesAtSameSampleRate) {
+	const SineClip inputClip(16000, 440, 16000);
+	vector<float> input(static_cast<size_t>(inputClip.size()));
+	inputClip.readBlock(0, input);
+
+	const SampleRateConverter converter(inputClip.clone(), 16000);
+	ASSERT_EQ(converter.size(), inputClip.size());
+	vector<float> output(input.size());
+	converter.readBlock(0, output);
+	EXPECT_EQ(output, input);
+	const auto read = converter.createSampleReader();
+	for (size_t i = 0; i < input.size(); i += 997) {
+		EXPECT_EQ(read(i), input[i]);
+	}
+
+	StreamingSampleRateConverter streamingConverter(16000, 16000);
+	vector<float> streamed;
+	streamingConverter.write(input, streamed);
+	streamingConverter.flush(streamed);
+	EXPECT_EQ(streamed, input);
+}
+
+TEST(StreamingSampleRateConverter, matchesSampleRateConverter) {
+	for (int inputSampleRate : { 44100, 16000, 8000 }) {
+		SCOPED_TRACE(inputSampleRate);
+		const SineClip inputClip(inputSampleRate, 440, inputSampleRate / 2 + 7);
+		vector<float> input(static_cast<size_t>(inputClip.size()));
+		inputClip.readBlock(0, input);
+
+		const unique_ptr<AudioClip> clip = inputClip.clone() | resample(16000);
+		vector<float> batch(static_cast<size_t>(clip->size()));
+		clip->readBlock(0, batch);
+
+		// Feed the input in blocks of varying size
+		StreamingSampleRateConverter converter(inputSampleRate, 16000);
+		vector<float> streamed;
+		size_t blockSize = 1;
+		for (size_t start = 0; start < input.size(); start += blockSize) {
+			blockSize = std::min(blockSize * 3 % 997 + 1, input.size() - start);
+			converter.write(gsl::span<const float>(input.data() + start, blockSize), streamed);
+		}
+		converter.flush(streamed);
+
+		EXPECT_EQ(streamed, batch);
+	}
+}
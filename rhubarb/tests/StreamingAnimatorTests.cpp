@@ -0,0 +1,131 @@
+#include <gmock/gmock.h>
+#include <random>
+#include "animation/StreamingAnimator.h"
+#include "animation/mouthAnimation.h"
+
+using namespace testing;
+using std::vector;
+
+ShapeSet getAllShapes() {
+	ShapeSet result = ShapeConverter::getBasicShapes();
+	const ShapeSet extendedShapes = ShapeConverter::getExtendedShapes();
+	result.insert(extendedShapes.begin(), extendedShapes.end());
+	return result;
+}
+
+// Creates phones that resemble speech: words of several phones, separated by pauses of varying
+// length
+Timeline<Phone> createRandomPhones(centiseconds duration, unsigned int seed) {
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> phoneDistribution(
+		static_cast<int>(Phone::AO), static_cast<int>(Phone::W)
+	);
+	std::uniform_int_distribution<int> phoneCountDistribution(2, 8);
+	std::uniform_int_distribution<int> phoneDurationDistribution(3, 20);
+	std::uniform_int_distribution<int> pauseDurationDistribution(0, 80);
+
+	Timeline<Phone> phones;
+	centiseconds time = 20_cs;
+	while (true) {
+		const int phoneCount = phoneCountDistribution(random);
+		for (int i = 0; i < phoneCount; ++i) {
+			const centiseconds phoneEnd = time + centiseconds(phoneDurationDistribution(random));
+			if (phoneEnd > duration - 20_cs) return phones;
+
+			phones.set(time, phoneEnd, static_cast<Phone>(phoneDistribution(random)));
+			time = phoneEnd;
+		}
+		time += centiseconds(pauseDurationDistribution(random));
+	}
+}
+
+// Feeds the phones to a StreamingAnimator as they would arrive from recognition, in steps of the
+// specified length
+JoiningContinuousTimeline<Shape> animateStreaming(
+	const Timeline<Phone>& phones,
+	centiseconds duration,
+	centiseconds stepLength,
+	const ShapeSet& targetShapeSet
+) {
+	StreamingAnimator animator(targetShapeSet);
+	JoiningContinuousTimeline<Shape> result(TimeRange(0_cs, duration), Shape::X);
+	const auto addAnimation = [&](const JoiningContinuousTimeline<Shape>& animation) {
+		for (const auto& timedShape : animation) {
+			result.set(timedShape);
+		}
+	};
+
+	auto nextPhone = phones.begin();
+	for (centiseconds time = stepLength; time < duration; time += stepLength) {
+		// Phones are known once they have ended
+		Timeline<Phone> newPhones;
+		for (; nextPhone != phones.end() && nextPhone->getEnd() <= time; ++nextPhone) {
+			newPhones.set(*nextPhone);
+		}
+		const centiseconds completedTime =
+			nextPhone != phones.end() ? std::min(time, nextPhone->getStart()) : time;
+		addAnimation(animator.update(newPhones, completedTime));
+	}
+
+	Timeline<Phone> remainingPhones;
+	for (; nextPhone != phones.end(); ++nextPhone) {
+		remainingPhones.set(*nextPhone);
+	}
+	addAnimation(animator.finish(remainingPhones, duration));
+	return result;
+}
+
+JoiningContinuousTimeline<Shape> animateBatch(
+	const Timeline<Phone>& phones,
+	centiseconds duration,
+	const ShapeSet& targetShapeSet
+) {
+	BoundedTimeline<Phone> boundedPhones(TimeRange(0_cs, duration));
+	for (const auto& timedPhone : phones) {
+		boundedPhones.set(timedPhone);
+	}
+	return animate(boundedPhones, targetShapeSet);
+}
+
+// Returns the total duration for which the two animations show different shapes
+centiseconds getDifference(
+	const JoiningContinuousTimeline<Shape>& a,
+	const JoiningContinuousTimeline<Shape>& b
+) {
+	centiseconds result = 0_cs;
+	for (centiseconds time = a.getRange().getStart(); time < a.getRange().getEnd(); ++time) {
+		if (a.get(time)->getValue() != b.get(time)->getValue()) ++result;
+	}
+	return result;
+}
+
+TEST(StreamingAnimator, coversEntireRange) {
+	const centiseconds duration = 1000_cs;
+	const Timeline<Phone> phones = createRandomPhones(duration, 0);
+	const ShapeSet targetShapeSet = getAllShapes();
+
+	StreamingAnimator animator(targetShapeSet);
+	const JoiningContinuousTimeline<Shape> first = animator.update(phones, 500_cs);
+	EXPECT_EQ(first.getRange(), TimeRange(0_cs, 500_cs - StreamingAnimator::lookahead));
+	const JoiningContinuousTimeline<Shape> second = animator.finish(Timeline<Phone>(), duration);
+	EXPECT_EQ(second.getRange(), TimeRange(500_cs - StreamingAnimator::lookahead, duration));
+}
+
+TEST(StreamingAnimator, matchesBatchAnimation) {
+	// Avoiding static segments weighs alternatives across the whole animation, so in rare cases,
+	// phones can affect shapes beyond the lookahead. Everywhere else, the result must be identical.
+	const centiseconds duration = 6000_cs;
+	const ShapeSet targetShapeSet = getAllShapes();
+	for (unsigned int seed = 0; seed < 10; ++seed) {
+		SCOPED_TRACE(seed);
+		const Timeline<Phone> phones = createRandomPhones(duration, seed);
+		const JoiningContinuousTimeline<Shape> batch = animateBatch(phones, duration, targetShapeSet);
+		for (centiseconds stepLength : { 1_cs, 10_cs, 37_cs }) {
+			SCOPED_TRACE(stepLength);
+			const JoiningContinuousTimeline<Shape> streaming =
+				animateStreaming(phones, duration, stepLength, targetShapeSet);
+			EXPECT_EQ(streaming.getRange(), batch.getRange());
+			EXPECT_LE(getDifference(batch, streaming), duration / 200);
+		}
+	}
+}
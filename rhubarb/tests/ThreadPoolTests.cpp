@@ -0,0 +1,136 @@
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <numeric>
+#include <mutex>
+#include "tools/parallel.h"
+
+using namespace testing;
+using std::vector;
+
+TEST(ThreadPool, processesAllElements) {
+	ThreadPool threadPool(4);
+	vector<int> values(1000, 0);
+	runParallel(threadPool, [](int& value) { ++value; }, values);
+	EXPECT_THAT(values, Each(1));
+}
+
+TEST(ThreadPool, supportsNestedParallelism) {
+	// Tasks waiting for their own subtasks must not starve the pool, even with a single thread
+	for (int threadCount : { 1, 3 }) {
+		SCOPED_TRACE(threadCount);
+		ThreadPool threadPool(threadCount);
+		vector<vector<int>> groups(20, vector<int>(50, 0));
+		runParallel(
+			threadPool,
+			[](vector<int>& group) {
+				EXPECT_NE(ThreadPool::getCurrent(), nullptr);
+				runParallel([](int& value) { ++value; }, group, 4);
+			},
+			groups
+		);
+		for (const auto& group : groups) {
+			EXPECT_THAT(group, Each(1));
+		}
+	}
+}
+
+TEST(ThreadPool, rethrowsException) {
+	ThreadPool threadPool(4);
+	vector<int> values(100);
+	std::iota(values.begin(), values.end(), 0);
+	EXPECT_THROW(
+		runParallel(
+			threadPool,
+			[](int& value) { if (value == 42) throw std::runtime_error("42"); },
+			values
+		),
+		std::runtime_error
+	);
+}
+
+TEST(ThreadPool, runsHigherPriorityTasksFirst) {
+	ThreadPool threadPool(1);
+
+	// Keep the only worker busy while scheduling
+	std::atomic<bool> started(false);
+	std::atomic<bool> released(false);
+	threadPool.schedule([&] {
+		started = true;
+		while (!released) std::this_thread::yield();
+	});
+	while (!started) std::this_thread::yield();
+
+	std::mutex mutex;
+	vector<int> order;
+	for (int priority : { 1, 3, 2, 3 }) {
+		threadPool.schedule([&, priority] {
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(priority);
+		}, priority);
+	}
+	released = true;
+	threadPool.waitUntil([&] {
+		std::lock_guard<std::mutex> lock(mutex);
+		return order.size() == 4;
+	});
+	EXPECT_THAT(order, ElementsAre(3, 3, 2, 1));
+}
+
+TEST(runParallel, processesElementsByPriority) {
+	ThreadPool threadPool(1);
+	vector<int> values { 1, 5, 2, 4, 3 };
+	vector<int> order;
+	runParallel(
+		threadPool,
+		[&](int& value) { order.push_back(value); },
+		values,
+		2,
+		[](int& value) { return value; }
+	);
+	EXPECT_THAT(order, ElementsAre(5, 4, 3, 2, 1));
+}
+
+TEST(ParallelQueue, processesElementsAddedWhileRunning) {
+	ThreadPool threadPool(3);
+	std::mutex mutex;
+	vector<int> processed;
+	ParallelQueue<int> queue(threadPool, [&](int& value) {
+		std::lock_guard<std::mutex> lock(mutex);
+		processed.push_back(value);
+	}, 2);
+	for (int i = 0; i < 100; ++i) {
+		queue.add(i);
+	}
+	queue.finish();
+
+	std::sort(processed.begin(), processed.end());
+	vector<int> expected(100);
+	std::iota(expected.begin(), expected.end(), 0);
+	EXPECT_EQ(processed, expected);
+}
+
+TEST(ParallelQueue, processesInOrderOnCallingThreadIfSingleThreaded) {
+	ThreadPool threadPool(2);
+	vector<int> processed;
+	ParallelQueue<int> queue(threadPool, [&](int& value) {
+		EXPECT_EQ(ThreadPool::getCurrent(), nullptr);
+		processed.push_back(value);
+	}, 1);
+	for (int value : { 3, 1, 2 }) {
+		queue.add(value);
+		EXPECT_EQ(processed.back(), value);
+	}
+	queue.finish();
+	EXPECT_THAT(processed, ElementsAre(3, 1, 2));
+}
+
+TEST(ParallelQueue, rethrowsException) {
+	ThreadPool threadPool(2);
+	ParallelQueue<int> queue(threadPool, [](int& value) {
+		if (value == 5) throw std::runtime_error("failed");
+	}, 2);
+	for (int i = 0; i < 10; ++i) {
+		queue.add(i);
+	}
+	EXPECT_THROW(queue.finish(), std::runtime_error);
+}
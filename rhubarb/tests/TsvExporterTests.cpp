@@ -0,0 +1,47 @@
+#include <gmock/gmock.h>
+#include <sstream>
+#include "exporters/TsvExporter.h"
+
+using namespace testing;
+using std::string;
+
+JoiningContinuousTimeline<Shape> createAnimation() {
+	JoiningContinuousTimeline<Shape> animation(TimeRange(0_cs, 300_cs), Shape::X);
+	animation.set(20_cs, 45_cs, Shape::B);
+	animation.set(45_cs, 52_cs, Shape::C);
+	animation.set(52_cs, 130_cs, Shape::F);
+	animation.set(180_cs, 250_cs, Shape::A);
+	return animation;
+}
+
+TEST(TsvStreamExporter, matchesTsvExporter) {
+	const JoiningContinuousTimeline<Shape> animation = createAnimation();
+	const ShapeSet targetShapeSet = ShapeConverter::getBasicShapes();
+
+	std::ostringstream batchStream;
+	TsvExporter().exportAnimation(ExporterInput("test.wav", animation, targetShapeSet), batchStream);
+
+	// Split the animation into parts, some of which begin or end within a shape
+	for (centiseconds partLength : { 1_cs, 7_cs, 45_cs, 300_cs }) {
+		SCOPED_TRACE(partLength);
+		std::ostringstream streamStream;
+		TsvStreamExporter exporter(targetShapeSet, streamStream);
+		for (centiseconds start = 0_cs; start < animation.getRange().getEnd(); start += partLength) {
+			const TimeRange partRange(start, std::min(start + partLength, animation.getRange().getEnd()));
+			exporter.exportAnimation(JoiningContinuousTimeline<Shape>(partRange, Shape::X, animation));
+		}
+		exporter.finish();
+		EXPECT_EQ(streamStream.str(), batchStream.str());
+	}
+}
+
+TEST(TsvStreamExporter, joinsShapesAcrossParts) {
+	const ShapeSet targetShapeSet = ShapeConverter::getBasicShapes();
+	std::ostringstream stream;
+	TsvStreamExporter exporter(targetShapeSet, stream);
+	exporter.exportAnimation(JoiningContinuousTimeline<Shape>(TimeRange(0_cs, 10_cs), Shape::B));
+	exporter.exportAnimation(JoiningContinuousTimeline<Shape>(TimeRange(10_cs, 10_cs), Shape::X));
+	exporter.exportAnimation(JoiningContinuousTimeline<Shape>(TimeRange(10_cs, 20_cs), Shape::B));
+	exporter.finish();
+	EXPECT_EQ(stream.str(), "0.00\tB\n0.20\tA\n");
+}
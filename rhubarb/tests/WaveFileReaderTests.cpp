@@ -1,5 +1,8 @@
 #include <gmock/gmock.h>
 #include "audio/WaveFileReader.h"
+#include "audio/AudioSegment.h"
+#include "audio/SampleRateConverter.h"
+#include "audio/DcOffset.h"
 #include "tools/platformTools.h"
 
 using namespace testing;
@@ -184,3 +187,45 @@ TEST(getWaveFormatInfo, uint8FromSoundforge) {
 	EXPECT_EQ(formatInfo.dataOffset, 44);
 }
 
+void expectBlockMatchesSamples(const AudioClip& audioClip, AudioClip::size_type start, AudioClip::size_type count) {
+	std::vector<float> block(static_cast<size_t>(count));
+	audioClip.readBlock(start, block);
+
+	const auto read = audioClip.createSampleReader();
+	for (AudioClip::size_type i = 0; i < count; ++i) {
+		ASSERT_EQ(block[i], read(start + i)) << "Sample index " << start + i;
+	}
+}
+
+TEST(WaveFileReader, readBlockMatchesSampleReader) {
+	for (const char* fileName : {
+		"sine-triangle-uint8-ffmpeg.wav",
+		"sine-triangle-int16-ffmpeg.wav",
+		"sine-triangle-int24-ffmpeg.wav",
+		"sine-triangle-int32-ffmpeg.wav",
+		"sine-triangle-float32-ffmpeg.wav",
+		"sine-triangle-float64-ffmpeg.wav"
+	}) {
+		SCOPED_TRACE(fileName);
+		const WaveFileReader reader(getBinDirectory() / "tests/resources" / fileName);
+		expectBlockMatchesSamples(reader, 0, 1000);
+		expectBlockMatchesSamples(reader, reader.size() - 1000, 1000);
+	}
+}
+
+TEST(WaveFileReader, readBlockMatchesSampleReaderForProcessedAudio) {
+	const std::unique_ptr<AudioClip> audioClip =
+		std::make_unique<WaveFileReader>(getBinDirectory() / "tests/resources/sine-triangle-int16-ffmpeg.wav")
+		| segment(TimeRange(50_cs, 550_cs))
+		| resample(16000)
+		| addDcOffset(0.1f);
+	expectBlockMatchesSamples(*audioClip, 0, audioClip->size());
+	expectBlockMatchesSamples(*audioClip, 12345, 1);
+}
+
+TEST(WaveFileReader, readBlockThrowsBeyondClip) {
+	const WaveFileReader reader(getBinDirectory() / "tests/resources/sine-triangle-int16-ffmpeg.wav");
+	std::vector<float> block(10);
+	EXPECT_THROW(reader.readBlock(-1, block), std::invalid_argument);
+	EXPECT_THROW(reader.readBlock(reader.size() - 5, block), std::invalid_argument);
+}
@@ -29,4 +29,39 @@ TEST(wordToPhones, basic) {
 		EXPECT_THAT(wordToPhones(word.first), ElementsAreArray(word.second))
 			<< "Original word: '" << word.first << "'";
 	}
-}
\ No newline at end of file
+}
+
+TEST(wordToPhones, anchoredRules) {
+	// Initial "kn", "gn", and "ps" lose their first letter, but only at the start of a word
+	EXPECT_THAT(wordToPhones("knot"), ElementsAre(Phone::N, Phone::AA, Phone::T));
+	EXPECT_THAT(wordToPhones("unknown"), ElementsAre(Phone::AH, Phone::NG, Phone::K, Phone::N, Phone::AW, Phone::N));
+	EXPECT_THAT(wordToPhones("gnome"), ElementsAre(Phone::N, Phone::OW, Phone::M));
+	EXPECT_THAT(wordToPhones("signal"), ElementsAre(Phone::S, Phone::IH, Phone::G, Phone::N, Phone::AE, Phone::L));
+	EXPECT_THAT(wordToPhones("psalm"), ElementsAre(Phone::S, Phone::AO, Phone::L, Phone::M));
+	EXPECT_THAT(wordToPhones("lapse"), ElementsAre(Phone::L, Phone::AE, Phone::P, Phone::S));
+
+	// "x" is voiced only after an initial "e" and before a vowel
+	EXPECT_THAT(wordToPhones("exact"), ElementsAre(Phone::EH, Phone::G, Phone::Z, Phone::AE, Phone::K, Phone::T));
+	EXPECT_THAT(wordToPhones("taxi"), ElementsAre(Phone::T, Phone::AE, Phone::K, Phone::S, Phone::IY));
+	EXPECT_THAT(wordToPhones("next"), ElementsAre(Phone::N, Phone::EH, Phone::K, Phone::S, Phone::T));
+
+	// A final "h" after a vowel is silent
+	EXPECT_THAT(wordToPhones("ah"), ElementsAre(Phone::AH));
+	EXPECT_THAT(wordToPhones("ahead"), ElementsAre(Phone::EY, Phone::HH, Phone::IY, Phone::D));
+}
+
+TEST(wordToPhones, capturesAndRepetition) {
+	// "ough" depends on the following letter, which is captured and kept
+	EXPECT_THAT(wordToPhones("bought"), ElementsAre(Phone::B, Phone::AO, Phone::T));
+	EXPECT_THAT(wordToPhones("though"), ElementsAre(Phone::TH, Phone::OW));
+
+	// A final "y" after one to three initial consonants is a diphthong
+	EXPECT_THAT(wordToPhones("by"), ElementsAre(Phone::B, Phone::AY));
+	EXPECT_THAT(wordToPhones("try"), ElementsAre(Phone::T, Phone::R, Phone::AY));
+	EXPECT_THAT(wordToPhones("spry"), ElementsAre(Phone::S, Phone::P, Phone::R, Phone::AY));
+	EXPECT_THAT(wordToPhones("happy"), ElementsAre(Phone::HH, Phone::AE, Phone::P, Phone::IY));
+
+	// "wh" keeps the letter captured on either side
+	EXPECT_THAT(wordToPhones("what"), ElementsAre(Phone::W, Phone::AA, Phone::T));
+	EXPECT_THAT(wordToPhones("who"), ElementsAre(Phone::HH, Phone::OW));
+}
@@ -0,0 +1,56 @@
+#include <gmock/gmock.h>
+#include <cmath>
+#include "recognition/languageModels.h"
+
+using namespace testing;
+using std::vector;
+using std::string;
+
+// Describes an n-gram as words with probability and backoff weight (not logarithmic)
+struct NGramValues {
+	vector<string> words;
+	double probability;
+	double backoff;
+};
+
+vector<NGramValues> getNGramValues(const NGramLanguageModel& languageModel, int order) {
+	vector<NGramValues> result;
+	for (const auto& ngram : languageModel.ngrams[order - 1]) {
+		vector<string> words;
+		for (int i = 0; i < order; ++i) {
+			words.push_back(languageModel.words[ngram.wordIds[i]]);
+		}
+		result.push_back({ words, std::pow(10, ngram.log10Probability), std::pow(10, ngram.log10Backoff) });
+	}
+	return result;
+}
+
+MATCHER_P3(IsNGram, words, probability, backoff, "") {
+	return arg.words == vector<string>(words)
+		&& std::abs(arg.probability - probability) < 1e-9
+		&& std::abs(arg.backoff - backoff) < 1e-9;
+}
+
+TEST(estimateLanguageModel, estimatesNGrams) {
+	const NGramLanguageModel languageModel =
+		estimateLanguageModel({ "<s>", "b", "a", "b", "</s>" });
+
+	EXPECT_THAT(languageModel.words, ElementsAre("</s>", "<s>", "a", "b"));
+	EXPECT_THAT(getNGramValues(languageModel, 1), ElementsAre(
+		IsNGram(vector<string> { "</s>" }, 0.1, 0.5),
+		IsNGram(vector<string> { "<s>" }, 0.1, 0.625),
+		IsNGram(vector<string> { "a" }, 0.1, 0.625),
+		IsNGram(vector<string> { "b" }, 0.2, 0.625)
+	));
+	EXPECT_THAT(getNGramValues(languageModel, 2), ElementsAre(
+		IsNGram(vector<string> { "<s>", "b" }, 0.5, 0.5 / 0.75),
+		IsNGram(vector<string> { "a", "b" }, 0.5, 0.5 / 0.75),
+		IsNGram(vector<string> { "b", "</s>" }, 0.25, 0.5),
+		IsNGram(vector<string> { "b", "a" }, 0.25, 1.0)
+	));
+	EXPECT_THAT(getNGramValues(languageModel, 3), ElementsAre(
+		IsNGram(vector<string> { "<s>", "b", "a" }, 0.5, 1.0),
+		IsNGram(vector<string> { "a", "b", "</s>" }, 0.5, 1.0),
+		IsNGram(vector<string> { "b", "a", "b" }, 0.5, 1.0)
+	));
+}
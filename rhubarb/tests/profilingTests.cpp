@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <boost/property_tree/json_parser.hpp>
+#include "tools/profiling.h"
+
+using namespace testing;
+using std::string;
+using std::vector;
+
+TEST(profiling, recordsNestedTimers) {
+	profiling::enable();
+	{
+		profiling::ScopedTimer outerTimer("outer");
+		profiling::ScopedTimer innerTimer("inner", "detail");
+	}
+
+	const vector<profiling::Event> events = profiling::getEvents();
+	ASSERT_EQ(events.size(), 2u);
+	EXPECT_EQ(string(events[0].name), "outer");
+	EXPECT_EQ(events[0].detail, "");
+	EXPECT_EQ(string(events[1].name), "inner");
+	EXPECT_EQ(events[1].detail, "detail");
+	EXPECT_LE(events[0].start, events[1].start);
+	EXPECT_GE(events[0].start + events[0].duration, events[1].start + events[1].duration);
+}
+
+TEST(profiling, recordsEachThreadSeparately) {
+	profiling::enable();
+	vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([] {
+			profiling::ScopedTimer timer("work");
+			profiling::count("items", 5);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	const vector<profiling::Event> events = profiling::getEvents();
+	ASSERT_EQ(events.size(), 4u);
+	std::set<int> threadIndices;
+	for (const auto& event : events) {
+		threadIndices.insert(event.threadIndex);
+	}
+	EXPECT_EQ(threadIndices.size(), 4u);
+	EXPECT_EQ(profiling::getCounters().at("items"), 20);
+}
+
+TEST(profiling, enableDiscardsEarlierData) {
+	profiling::enable();
+	{
+		profiling::ScopedTimer timer("old");
+		profiling::count("old");
+	}
+	profiling::enable();
+	EXPECT_THAT(profiling::getEvents(), IsEmpty());
+	EXPECT_THAT(profiling::getCounters(), IsEmpty());
+}
+
+TEST(profiling, writesChromeTrace) {
+	profiling::enable();
+	{
+		profiling::ScopedTimer timer("stage", "\"quoted\"");
+		profiling::count("items", 3);
+	}
+
+	std::stringstream stream;
+	profiling::writeChromeTrace(stream);
+	boost::property_tree::ptree trace;
+	boost::property_tree::read_json(stream, trace);
+
+	const auto& events = trace.get_child("traceEvents");
+	ASSERT_EQ(events.size(), 1u);
+	const auto& event = events.begin()->second;
+	EXPECT_EQ(event.get<string>("name"), "stage");
+	EXPECT_EQ(event.get<string>("ph"), "X");
+	EXPECT_EQ(event.get<string>("args.detail"), "\"quoted\"");
+	EXPECT_EQ(trace.get<int>("otherData.items"), 3);
+}
+
+TEST(profiling, recordsLazyDetail) {
+	profiling::enable();
+	{
+		profiling::ScopedTimer timer("stage", [] { return string("detail"); });
+	}
+
+	const vector<profiling::Event> events = profiling::getEvents();
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].detail, "detail");
+}
+
+TEST(profiling, dropsEventsBeyondLimit) {
+	profiling::enable();
+	for (size_t i = 0; i < profiling::maxEventsPerThread + 5; ++i) {
+		profiling::ScopedTimer timer("stage");
+	}
+
+	EXPECT_EQ(profiling::getEvents().size(), profiling::maxEventsPerThread);
+	EXPECT_EQ(profiling::getCounters().at("dropped events"), 5);
+}
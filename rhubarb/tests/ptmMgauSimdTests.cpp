@@ -0,0 +1,124 @@
+#include <gmock/gmock.h>
+#include <random>
+#include <ptm_mgau_simd.h>
+
+using namespace testing;
+using std::vector;
+
+struct DensityBlock {
+	vector<mfcc_t> mean;
+	vector<mfcc_t> var;
+	vector<mfcc_t> det;
+	vector<mfcc_t> obs;
+};
+
+DensityBlock createRandomBlock(std::mt19937& random, int ceplen) {
+	std::normal_distribution<mfcc_t> normal;
+	std::uniform_real_distribution<mfcc_t> positive(0.01f, 2.0f);
+	std::uniform_real_distribution<mfcc_t> determinant(-40.0f, 0.0f);
+	DensityBlock block;
+	for (int i = 0; i < ceplen * PTM_BLOCK_WIDTH; ++i) {
+		block.mean.push_back(normal(random));
+		block.var.push_back(positive(random));
+	}
+	for (int i = 0; i < PTM_BLOCK_WIDTH; ++i) {
+		block.det.push_back(determinant(random));
+	}
+	for (int i = 0; i < ceplen; ++i) {
+		block.obs.push_back(normal(random));
+	}
+	return block;
+}
+
+// Evaluates a single density the way the original eval_cb loop did, before densities were
+// evaluated in blocks. Returns the log likelihood without pruning.
+mfcc_t evaluateDensityOriginal(const DensityBlock& block, int lane, int ceplen) {
+	// The original code stores the dimensions of each density contiguously
+	vector<mfcc_t> mean, var;
+	for (int j = 0; j < ceplen; ++j) {
+		mean.push_back(block.mean[j * PTM_BLOCK_WIDTH + lane]);
+		var.push_back(block.var[j * PTM_BLOCK_WIDTH + lane]);
+	}
+
+	mfcc_t d = block.det[lane];
+	int j = 0;
+	for (; j < ceplen % 4; ++j) {
+		const mfcc_t diff = block.obs[j] - mean[j];
+		const mfcc_t sqdiff = diff * diff;
+		const mfcc_t component = sqdiff * var[j];
+		d = d - component;
+	}
+	for (; j < ceplen; j += 4) {
+		mfcc_t component[4];
+		for (int k = 0; k < 4; ++k) {
+			const mfcc_t diff = block.obs[j + k] - mean[j + k];
+			const mfcc_t sqdiff = diff * diff;
+			component[k] = sqdiff * var[j + k];
+		}
+		for (int k = 0; k < 4; ++k) {
+			d = d - component[k];
+		}
+	}
+	return d;
+}
+
+// Checks that the kernel produces bit-identical results to the original scalar code
+void expectSameAsOriginal(ptm_eval_block_func_t kernel) {
+	std::mt19937 random(42);
+	int resultCount = 0;
+	for (int iteration = 0; iteration < 1000; ++iteration) {
+		const int ceplen = iteration % 2 == 0 ? 13 : 39;
+		const DensityBlock block = createRandomBlock(random, ceplen);
+		const mfcc_t thresh = static_cast<mfcc_t>(-10 * (iteration % 10));
+
+		mfcc_t expected[PTM_BLOCK_WIDTH];
+		bool expectedResult = false;
+		for (int lane = 0; lane < PTM_BLOCK_WIDTH; ++lane) {
+			expected[lane] = evaluateDensityOriginal(block, lane, ceplen);
+			if (expected[lane] >= thresh) expectedResult = true;
+		}
+		mfcc_t actual[PTM_BLOCK_WIDTH];
+		const int actualResult = kernel(
+			block.mean.data(), block.var.data(), block.det.data(), block.obs.data(), ceplen, thresh, actual
+		);
+		ASSERT_EQ(actualResult != 0, expectedResult) << "iteration " << iteration;
+		if (!expectedResult) continue;
+
+		++resultCount;
+		for (int lane = 0; lane < PTM_BLOCK_WIDTH; ++lane) {
+			ASSERT_EQ(actual[lane], expected[lane]) << "iteration " << iteration << ", lane " << lane;
+		}
+	}
+	// Make sure both outcomes were tested
+	EXPECT_GT(resultCount, 0);
+	EXPECT_LT(resultCount, 1000);
+}
+
+TEST(ptmMgauSimd, referenceMatchesOriginal) {
+	expectSameAsOriginal(ptm_eval_block_c);
+}
+
+#ifdef PTM_HAVE_SSE2
+TEST(ptmMgauSimd, sse2MatchesOriginal) {
+	expectSameAsOriginal(ptm_eval_block_sse2);
+}
+#endif
+
+#ifdef PTM_HAVE_AVX
+TEST(ptmMgauSimd, avxMatchesOriginal) {
+	// Can't be tested on this CPU
+	if (!ptm_avx_supported()) return;
+
+	expectSameAsOriginal(ptm_eval_block_avx);
+}
+#endif
+
+#ifdef PTM_HAVE_NEON
+TEST(ptmMgauSimd, neonMatchesOriginal) {
+	expectSameAsOriginal(ptm_eval_block_neon);
+}
+#endif
+
+TEST(ptmMgauSimd, selectedKernelMatchesOriginal) {
+	expectSameAsOriginal(ptm_eval_block_select());
+}
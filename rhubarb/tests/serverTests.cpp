@@ -0,0 +1,200 @@
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "rhubarb/server.h"
+#include "rhubarb/RecognizerType.h"
+#include "recognition/utteranceSplitting.h"
+#include "tools/textFiles.h"
+
+using namespace testing;
+using std::string;
+using std::vector;
+using std::filesystem::path;
+using boost::property_tree::ptree;
+
+// Writes a 16-bit mono WAVE file at 16kHz containing the specified samples
+void writeWaveFile(const path& filePath, const vector<int16_t>& samples) {
+	const int sampleRate = 16000;
+	const uint32_t dataSize = static_cast<uint32_t>(samples.size() * 2);
+	std::ofstream file(filePath, std::ios::binary);
+	const auto write = [&](uint32_t value, int byteCount) {
+		for (int i = 0; i < byteCount; ++i) {
+			file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	};
+	file.write("RIFF", 4);
+	write(36 + dataSize, 4);
+	file.write("WAVEfmt ", 8);
+	write(16, 4); // Chunk size
+	write(1, 2); // PCM
+	write(1, 2); // Channel count
+	write(sampleRate, 4);
+	write(sampleRate * 2, 4); // Bytes per second
+	write(2, 2); // Bytes per frame
+	write(16, 2); // Bits per sample
+	file.write("data", 4);
+	write(dataSize, 4);
+	for (int16_t sample : samples) {
+		write(static_cast<uint16_t>(sample), 2);
+	}
+}
+
+// Creates seconds of noise bursts that voice activity detection mistakes for speech
+vector<int16_t> createNoiseBursts(int seconds) {
+	const int sampleRate = 16000;
+	vector<int16_t> samples(sampleRate * seconds);
+	std::mt19937 random(0);
+	std::normal_distribution<float> noise(0.0f, 5000.0f);
+	for (size_t i = 0; i < samples.size(); ++i) {
+		const double time = static_cast<double>(i) / sampleRate;
+		const double envelope = std::abs(std::sin(2 * 3.14159 * time));
+		samples[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, envelope * noise(random))));
+	}
+	return samples;
+}
+
+class ServerTest : public Test {
+protected:
+	ServerTest() :
+		directory(
+			std::filesystem::temp_directory_path()
+			/ (string("rhubarb-server-test-") + UnitTest::GetInstance()->current_test_info()->name())
+		),
+		defaultSettings {
+			RecognizerType::Phonetic,
+			ExportFormat::Tsv,
+			"GHX",
+			24.0,
+			false,
+			defaultMaxUtteranceLength,
+			boost::none
+		}
+	{
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		writeWaveFile(directory / "silence.wav", vector<int16_t>(16000));
+	}
+
+	~ServerTest() override {
+		std::filesystem::remove_all(directory);
+	}
+
+	// Runs the server with the specified input lines, returning the parsed output lines
+	vector<ptree> run(const vector<string>& jobs) {
+		std::ostringstream inputStream;
+		for (const string& job : jobs) {
+			inputStream << job << "\n";
+		}
+		std::istringstream serverInput(inputStream.str());
+		std::ostringstream serverOutput;
+		runServer(serverInput, serverOutput, defaultSettings, 1);
+
+		vector<ptree> results;
+		std::istringstream outputStream(serverOutput.str());
+		string line;
+		while (std::getline(outputStream, line)) {
+			std::istringstream lineStream(line);
+			ptree result;
+			boost::property_tree::read_json(lineStream, result);
+			results.push_back(result);
+		}
+		return results;
+	}
+
+	// Returns a job JSON for the specified test file with the specified additional properties
+	string createJob(
+		const string& id,
+		const string& properties = "",
+		const string& fileName = "silence.wav"
+	) {
+		std::ostringstream stream;
+		stream << R"({ "id": ")" << id << R"(", "inputFile": ")"
+			<< (directory / fileName).generic_u8string() << R"(")" << properties << " }";
+		return stream.str();
+	}
+
+	path directory;
+	JobSettings defaultSettings;
+};
+
+TEST_F(ServerTest, processesValidJob) {
+	const vector<ptree> results = run({ createJob("a") });
+	ASSERT_EQ(results.size(), 1u);
+	EXPECT_EQ(results[0].get<string>("id"), "a");
+	EXPECT_EQ(results[0].get<string>("type"), "success");
+	EXPECT_EQ(results[0].get<string>("result"), "0.00\tX\n1.00\tX\n");
+}
+
+TEST_F(ServerTest, reportsMalformedJsonAndContinues) {
+	const vector<ptree> results = run({ "{ \"id\": \"a\", ", "", createJob("b") });
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_EQ(results[0].get<string>("id"), "");
+	EXPECT_EQ(results[0].get<string>("type"), "failure");
+	EXPECT_THAT(results[0].get<string>("reason"), HasSubstr("Invalid job JSON."));
+	EXPECT_EQ(results[1].get<string>("id"), "b");
+	EXPECT_EQ(results[1].get<string>("type"), "success");
+}
+
+TEST_F(ServerTest, reportsMissingFile) {
+	const string missingFile = (directory / "missing.wav").generic_u8string();
+	const vector<ptree> results = run({
+		R"({ "id": "a", "inputFile": ")" + missingFile + R"(" })",
+		R"({ "id": "b" })"
+	});
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_EQ(results[0].get<string>("id"), "a");
+	EXPECT_EQ(results[0].get<string>("type"), "failure");
+	EXPECT_THAT(results[0].get<string>("reason"), HasSubstr("missing.wav"));
+	EXPECT_EQ(results[1].get<string>("type"), "failure");
+	EXPECT_THAT(results[1].get<string>("reason"), HasSubstr("Job has no input file."));
+}
+
+TEST_F(ServerTest, appliesSettingsOverrides) {
+	const path outputFilePath = directory / "output.json";
+	const vector<ptree> results = run({
+		createJob("basic", R"(, "extendedShapes": "")"),
+		createJob("json", R"(, "exportFormat": "json", "recognizer": "pocketSphinx")"),
+		createJob("file", R"(, "outputFile": ")" + outputFilePath.generic_u8string() + R"(")"),
+		createJob("unknown", R"(, "exportFormat": "mp3")")
+	});
+	ASSERT_EQ(results.size(), 4u);
+
+	// Without extended shapes, the closed mouth is A rather than X
+	EXPECT_EQ(results[0].get<string>("result"), "0.00\tA\n1.00\tA\n");
+
+	EXPECT_EQ(results[1].get<string>("type"), "success");
+	EXPECT_THAT(results[1].get<string>("result"), HasSubstr("\"mouthCues\""));
+
+	EXPECT_EQ(results[2].get<string>("type"), "success");
+	EXPECT_EQ(results[2].get<string>("outputFile"), outputFilePath.generic_u8string());
+	EXPECT_EQ(readUtf8File(outputFilePath), "0.00\tX\n1.00\tX\n");
+
+	EXPECT_EQ(results[3].get<string>("type"), "failure");
+}
+
+TEST_F(ServerTest, runsPhoneticRecognizers) {
+	// The word recognizer dismisses noise, but the phonetic recognizers map it to phones
+	writeWaveFile(directory / "noise.wav", createNoiseBursts(3));
+	const vector<ptree> results = run({
+		createJob("phonetic", R"(, "recognizer": "phonetic")", "noise.wav"),
+		createJob("phoneticDraft", R"(, "recognizer": "phoneticDraft")", "noise.wav")
+	});
+	ASSERT_EQ(results.size(), 2u);
+	for (const ptree& result : results) {
+		SCOPED_TRACE(result.get<string>("id"));
+		ASSERT_EQ(result.get<string>("type"), "success");
+		EXPECT_THAT(result.get<string>("result"), Not(MatchesRegex("(\\S+\tX\n)*")));
+		EXPECT_THAT(result.get<string>("result"), EndsWith("3.00\tX\n"));
+	}
+}
+
+TEST(RecognizerType, roundTripsNames) {
+	for (RecognizerType type : RecognizerTypeConverter::get().getValues()) {
+		const string name = RecognizerTypeConverter::get().toString(type);
+		EXPECT_EQ(RecognizerTypeConverter::get().parse(name), type);
+	}
+	EXPECT_EQ(RecognizerTypeConverter::get().parse("phoneticDraft"), RecognizerType::PhoneticDraft);
+}
@@ -0,0 +1,142 @@
+#include <gmock/gmock.h>
+#include "recognition/utteranceSplitting.h"
+
+using namespace testing;
+using std::vector;
+
+TEST(splitUtterance, keepsShortUtterance) {
+	const TimeRange utterance(100_cs, 2100_cs);
+	const vector<UtteranceWindow> windows =
+		splitUtterance(utterance, 2000_cs, [](TimeRange) -> centiseconds {
+			throw std::logic_error("Unexpected split.");
+		});
+	ASSERT_EQ(windows.size(), 1u);
+	EXPECT_EQ(windows[0].window, utterance);
+	EXPECT_EQ(windows[0].core, utterance);
+}
+
+TEST(splitUtterance, splitsIntoOverlappingWindows) {
+	const TimeRange utterance(100_cs, 6100_cs);
+	vector<TimeRange> searchRanges;
+	const vector<UtteranceWindow> windows = splitUtterance(utterance, 2000_cs, [&](TimeRange range) {
+		searchRanges.push_back(range);
+		return range.getEnd();
+	});
+
+	ASSERT_GE(windows.size(), 2u);
+	EXPECT_EQ(searchRanges.size(), windows.size() - 1);
+	EXPECT_EQ(windows.front().core.getStart(), utterance.getStart());
+	EXPECT_EQ(windows.back().core.getEnd(), utterance.getEnd());
+	for (size_t i = 0; i < windows.size(); ++i) {
+		const UtteranceWindow& window = windows[i];
+		EXPECT_LE(window.window.getDuration(), 2000_cs);
+		EXPECT_LE(window.window.getStart(), window.core.getStart());
+		EXPECT_GE(window.window.getEnd(), window.core.getEnd());
+		if (i > 0) {
+			EXPECT_EQ(window.core.getStart(), windows[i - 1].core.getEnd());
+			EXPECT_LT(window.window.getStart(), windows[i - 1].core.getEnd());
+			EXPECT_GT(windows[i - 1].window.getEnd(), window.core.getStart());
+		}
+	}
+}
+
+TEST(splitUtterance, rejectsTooShortMaximum) {
+	EXPECT_THROW(
+		splitUtterance(TimeRange(0_cs, 10000_cs), 100_cs, [](TimeRange range) { return range.getStart(); }),
+		std::invalid_argument
+	);
+}
+
+TEST(stitchPhones, switchesWindowsBetweenPhones) {
+	const vector<UtteranceWindow> windows {
+		{ TimeRange(0_cs, 1100_cs), TimeRange(0_cs, 1000_cs) },
+		{ TimeRange(900_cs, 2000_cs), TimeRange(1000_cs, 2000_cs) }
+	};
+	// Both windows agree on a phone boundary at 1010_cs, but not at the split point
+	const vector<Timeline<Phone>> windowPhones {
+		Timeline<Phone> {
+			{ 950_cs, 990_cs, Phone::AA },
+			{ 990_cs, 1010_cs, Phone::B },
+			{ 1010_cs, 1100_cs, Phone::Noise }
+		},
+		Timeline<Phone> {
+			{ 900_cs, 995_cs, Phone::Noise },
+			{ 995_cs, 1010_cs, Phone::B },
+			{ 1010_cs, 1050_cs, Phone::D },
+			{ 1050_cs, 1090_cs, Phone::EH }
+		}
+	};
+	EXPECT_THAT(
+		stitchPhones(windows, windowPhones),
+		ElementsAre(
+			Timed<Phone>(950_cs, 990_cs, Phone::AA),
+			Timed<Phone>(990_cs, 1010_cs, Phone::B),
+			Timed<Phone>(1010_cs, 1050_cs, Phone::D),
+			Timed<Phone>(1050_cs, 1090_cs, Phone::EH)
+		)
+	);
+}
+
+TEST(stitchPhones, cutsAtSplitPointIfWindowsDisagree) {
+	const vector<UtteranceWindow> windows {
+		{ TimeRange(0_cs, 1100_cs), TimeRange(0_cs, 1000_cs) },
+		{ TimeRange(900_cs, 2000_cs), TimeRange(1000_cs, 2000_cs) }
+	};
+	const vector<Timeline<Phone>> windowPhones {
+		Timeline<Phone> { { 900_cs, 1100_cs, Phone::AA } },
+		Timeline<Phone> { { 900_cs, 1100_cs, Phone::EH } }
+	};
+	EXPECT_THAT(
+		stitchPhones(windows, windowPhones),
+		ElementsAre(
+			Timed<Phone>(900_cs, 1000_cs, Phone::AA),
+			Timed<Phone>(1000_cs, 1100_cs, Phone::EH)
+		)
+	);
+}
+
+TEST(stitchPhones, keepsStitchPointsInOrderForShortCores) {
+	// At the minimum length, split points can move so close together that the searches for
+	// stitch points around neighboring split points overlap
+	const TimeRange utterance(0_cs, minUtteranceSplitLength + 1_cs);
+	int splitIndex = 0;
+	const vector<UtteranceWindow> windows =
+		splitUtterance(utterance, minUtteranceSplitLength, [&](TimeRange range) {
+			return splitIndex++ % 2 == 0 ? range.getEnd() : range.getStart();
+		});
+	ASSERT_EQ(windows.size(), 3u);
+	ASSERT_LT(windows[1].core.getDuration(), 100_cs);
+
+	// Each pair of windows agrees on a single phone boundary just beyond the middle of the
+	// middle core
+	const centiseconds firstBoundary = windows[0].core.getEnd() + 48_cs;
+	const centiseconds secondBoundary = windows[1].core.getEnd() - 48_cs;
+	ASSERT_LT(secondBoundary, firstBoundary);
+	const vector<Timeline<Phone>> windowPhones {
+		Timeline<Phone> {
+			{ windows[0].window.getStart(), firstBoundary, Phone::AA },
+			{ firstBoundary, windows[0].window.getEnd(), Phone::AA }
+		},
+		Timeline<Phone> {
+			{ windows[1].window.getStart(), secondBoundary, Phone::EH },
+			{ secondBoundary, firstBoundary, Phone::EH },
+			{ firstBoundary, windows[1].window.getEnd(), Phone::EH }
+		},
+		Timeline<Phone> {
+			{ windows[2].window.getStart(), secondBoundary, Phone::IY },
+			{ secondBoundary, windows[2].window.getEnd(), Phone::IY }
+		}
+	};
+
+	const Timeline<Phone> phones = stitchPhones(windows, windowPhones);
+	// The phones of every window are used, without gaps
+	for (Phone phone : { Phone::AA, Phone::EH, Phone::IY }) {
+		EXPECT_THAT(phones, Contains(Property(&Timed<Phone>::getValue, phone)));
+	}
+	centiseconds time = utterance.getStart();
+	for (const Timed<Phone>& timedPhone : phones) {
+		EXPECT_EQ(timedPhone.getStart(), time);
+		time = timedPhone.getEnd();
+	}
+	EXPECT_EQ(time, utterance.getEnd());
+}
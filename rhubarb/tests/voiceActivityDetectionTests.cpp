@@ -0,0 +1,111 @@
+#include <gmock/gmock.h>
+#include <cmath>
+#include <random>
+#include "audio/voiceActivityDetection.h"
+#include "audio/MemoryAudioClip.h"
+#include "audio/SampleRateConverter.h"
+#include "audio/DcOffset.h"
+#include "audio/processing.h"
+
+using namespace testing;
+using std::vector;
+using boost::optional;
+
+// Adds the frames to the segmenter, returning all completed segments
+vector<TimeRange> segment(VoiceActivitySegmenter& segmenter, const std::string& frames) {
+	vector<TimeRange> result;
+	for (char frame : frames) {
+		if (const optional<TimeRange> segment = segmenter.addFrame(frame == '#')) {
+			result.push_back(*segment);
+		}
+	}
+	if (const optional<TimeRange> segment = segmenter.close()) {
+		result.push_back(*segment);
+	}
+	return result;
+}
+
+TEST(VoiceActivitySegmenter, fillsShortGaps) {
+	VoiceActivitySegmenter segmenter;
+	EXPECT_THAT(
+		segment(segmenter, "#####..........#####...........#####"),
+		ElementsAre(TimeRange(0_cs, 20_cs), TimeRange(31_cs, 36_cs))
+	);
+}
+
+TEST(VoiceActivitySegmenter, discardsShortSegments) {
+	VoiceActivitySegmenter segmenter;
+	EXPECT_THAT(
+		segment(segmenter, "####..............................#####"),
+		ElementsAre(TimeRange(34_cs, 39_cs))
+	);
+}
+
+TEST(VoiceActivitySegmenter, limitsSegmentLength) {
+	VoiceActivitySegmenter segmenter(10_cs);
+	EXPECT_THAT(
+		segment(segmenter, "###############"),
+		ElementsAre(TimeRange(0_cs, 10_cs), TimeRange(10_cs, 15_cs))
+	);
+}
+
+// Creates noise bursts of varying loudness, separated by silence
+MemoryAudioClip createNoiseBursts(int sampleRate, int seconds) {
+	auto samples = std::make_shared<vector<int16_t>>(sampleRate * seconds);
+	std::mt19937 random(0);
+	std::normal_distribution<float> noise(0.0f, 5000.0f);
+	for (size_t i = 0; i < samples->size(); ++i) {
+		const double time = static_cast<double>(i) / sampleRate;
+		const double envelope = std::fmod(time, 3.0) < 2.0 ? std::abs(std::sin(4 * 3.14159 * time)) : 0.0;
+		(*samples)[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, envelope * noise(random))));
+	}
+	return MemoryAudioClip(samples, sampleRate);
+}
+
+TEST(detectVoiceActivity, doesNotDependOnThreadCount) {
+	// Several minutes of noise bursts, so that the recording is analyzed in multiple chunks
+	const MemoryAudioClip clip = createNoiseBursts(16000, 200);
+
+	NullProgressSink progressSink;
+	const JoiningBoundedTimeline<void> singleThreaded = detectVoiceActivity(clip, 1, progressSink);
+	const JoiningBoundedTimeline<void> multiThreaded = detectVoiceActivity(clip, 4, progressSink);
+	EXPECT_GT(singleThreaded.size(), 50u);
+	EXPECT_EQ(multiThreaded, singleThreaded);
+}
+
+TEST(VoiceActivityStream, matchesDetectVoiceActivity) {
+	for (int sampleRate : { 8000, 16000 }) {
+		SCOPED_TRACE(sampleRate);
+
+		// Less than one analysis chunk, so that batch detection runs a single VAD pass
+		const MemoryAudioClip clip = createNoiseBursts(sampleRate, 30);
+		NullProgressSink progressSink;
+		vector<TimeRange> batchSegments;
+		for (const auto& timedActivity : detectVoiceActivity(clip, 1, progressSink)) {
+			batchSegments.push_back(timedActivity.getTimeRange());
+		}
+		EXPECT_GT(batchSegments.size(), 5u);
+
+		// The stream expects audio without DC offset
+		const std::unique_ptr<AudioClip> streamClip = clip.clone() | removeDcOffset();
+		vector<float> samples(static_cast<size_t>(streamClip->size()));
+		streamClip->readBlock(0, samples);
+
+		// Feed the stream in chunks of varying size
+		for (size_t chunkSize : { 1, 80, 1001, 16000 }) {
+			SCOPED_TRACE(chunkSize);
+			VoiceActivityStream stream(sampleRate);
+			vector<TimeRange> streamSegments;
+			for (size_t start = 0; start < samples.size(); start += chunkSize) {
+				const size_t count = std::min(chunkSize, samples.size() - start);
+				for (const TimeRange& segment : stream.write(gsl::span<const float>(&samples[start], count))) {
+					streamSegments.push_back(segment);
+				}
+			}
+			for (const TimeRange& segment : stream.close()) {
+				streamSegments.push_back(segment);
+			}
+			EXPECT_EQ(streamSegments, batchSegments);
+		}
+	}
+}